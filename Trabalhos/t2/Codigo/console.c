@@ -50,12 +50,18 @@ struct console_t {
   char txt_entrada[N_COL+1];
   char fila_de_comandos_externos[N_CMD_EXT];
   FILE *arquivo_de_log;
+  // modo lote: sem tela, terminais ligados a arquivos
+  bool lote;
+  FILE *arquivo_de_entrada[N_TERM];
+  FILE *arquivo_de_saida[N_TERM];
 };
 
 // CRIAÇÃO {{{1
 
 static console_t *console_global; // gambiarra para simplificar o uso de prints na console
-console_t *console_cria(void)
+static void liga_terminais_a_arquivos(console_t *self);
+
+console_t *console_cria(bool lote)
 {
   console_t *self = malloc(sizeof(*self));
   assert(self != NULL);
@@ -77,24 +83,49 @@ console_t *console_cria(void)
   strcpy(self->txt_entrada, "");
   self->fila_de_comandos_externos[0] = '\0';
   self->arquivo_de_log = fopen("log_da_console", "w");
+  self->lote = lote;
 
-  tela_init();
+  if (lote) {
+    liga_terminais_a_arquivos(self);
+  } else {
+    tela_init();
+  }
 
   return self;
 }
 
+static void liga_terminais_a_arquivos(console_t *self)
+{
+  for (int t = 0; t < N_TERM; t++) {
+    char nome[30];
+    sprintf(nome, "entrada_terminal_%c", 'a' + t);
+    self->arquivo_de_entrada[t] = fopen(nome, "r");
+    sprintf(nome, "saida_terminal_%c", 'a' + t);
+    self->arquivo_de_saida[t] = fopen(nome, "w");
+    terminal_define_arquivos(self->term[t], self->arquivo_de_entrada[t],
+                             self->arquivo_de_saida[t]);
+  }
+}
+
 static void console_desenha(console_t *self);
 
 void console_destroi(console_t *self)
 {
-  console_desenha(self);
   if (self->arquivo_de_log != NULL) fclose(self->arquivo_de_log);
-  tela_puts(COR_OCUPADO, "  digite ENTER para sair  ");
-  tela_atualiza();
-  while (tela_tecla() != '\n') {
-    ;
+  if (self->lote) {
+    for (int t = 0; t < N_TERM; t++) {
+      if (self->arquivo_de_entrada[t] != NULL) fclose(self->arquivo_de_entrada[t]);
+      if (self->arquivo_de_saida[t] != NULL) fclose(self->arquivo_de_saida[t]);
+    }
+  } else {
+    console_desenha(self);
+    tela_puts(COR_OCUPADO, "  digite ENTER para sair  ");
+    tela_atualiza();
+    while (tela_tecla() != '\n') {
+      ;
+    }
+    tela_fim();
   }
-  tela_fim();
 
   for (int t = 0; t < N_TERM; t++) {
     terminal_destroi(self->term[t]);
@@ -112,10 +143,10 @@ terminal_t *console_terminal(console_t *self, char id_terminal)
   return self->term[num_terminal];
 }
 
-static void atualiza_terminais(console_t *self)
+static void atualiza_terminais(console_t *self, int tics)
 {
   for (int t = 0; t < N_TERM; t++) {
-    terminal_tictac(self->term[t]);
+    terminal_avanca(self->term[t], tics);
   }
 }
 
@@ -258,6 +289,8 @@ static void interpreta_linha_entrada(console_t *self)
 // lê e guarda um caractere do teclado; interpreta linha se for 'enter'
 static void verifica_entrada(console_t *self)
 {
+  // no modo lote não tem teclado
+  if (self->lote) return;
   char ch = tela_tecla();
 
   int l = strlen(self->txt_entrada);
@@ -342,11 +375,52 @@ static void console_desenha(console_t *self)
 }
 
 // TICTAC {{{1
-void console_tictac(console_t *self)
+void console_tictac_terminais(console_t *self)
+{
+  atualiza_terminais(self, 1);
+}
+
+void console_avanca_terminais(console_t *self, int tics)
 {
+  atualiza_terminais(self, tics);
+}
+
+bool console_pede_interrupcao(console_t *self, irq_t irq)
+{
+  for (int t = 0; t < N_TERM; t++) {
+    if (terminal_pede_interrupcao(self->term[t], irq)) return true;
+  }
+  return false;
+}
+
+void console_atende_interrupcao(console_t *self, irq_t irq)
+{
+  for (int t = 0; t < N_TERM; t++) {
+    terminal_atende_interrupcao(self->term[t], irq);
+  }
+}
+
+int console_tics_ate_evento(console_t *self)
+{
+  int menor = 0;
+  for (int t = 0; t < N_TERM; t++) {
+    int tics = terminal_tics_ate_evento(self->term[t]);
+    if (tics != 0 && (menor == 0 || tics < menor)) menor = tics;
+  }
+  return menor;
+}
+
+void console_atualiza_tela(console_t *self)
+{
+  if (self->lote) return;
   verifica_entrada(self);
-  atualiza_terminais(self);
   console_desenha(self);
 }
 
+void console_tictac(console_t *self)
+{
+  console_tictac_terminais(self);
+  console_atualiza_tela(self);
+}
+
 // vim: foldmethod=marker
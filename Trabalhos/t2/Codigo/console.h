@@ -12,7 +12,11 @@
 typedef struct console_t console_t;
 
 // cria e inicializa a console
-console_t *console_cria(void);
+// se 'lote' for true, a console não usa a tela: as mensagens vão só para o
+//   arquivo de log, e cada terminal 'x' tem sua saída copiada para o arquivo
+//   "saida_terminal_x" e sua entrada lida do arquivo "entrada_terminal_x" (se
+//   existir)
+console_t *console_cria(bool lote);
 
 // destrói a console
 void console_destroi(console_t *self);
@@ -37,7 +41,32 @@ char console_comando_externo(console_t *self);
 // retorna o terminal identificado ('A', 'B', etc)
 terminal_t *console_terminal(console_t *self, char id_terminal);
 
+// avança o estado dos terminais em uma unidade de tempo
+// deve ser chamada a cada instrução executada
+void console_tictac_terminais(console_t *self);
+
+// avança o estado dos terminais em 'tics' unidades de tempo de uma vez
+// equivale a 'tics' chamadas a console_tictac_terminais
+void console_avanca_terminais(console_t *self, int tics);
+
+// retorna true se algum terminal está pedindo a interrupção 'irq'
+bool console_pede_interrupcao(console_t *self, irq_t irq);
+
+// retira o pedido da interrupção 'irq' de todos os terminais, porque ela foi
+//   aceita pela CPU (o SO vai verificar todos os terminais no atendimento)
+void console_atende_interrupcao(console_t *self, irq_t irq);
+
+// retorna em quantas unidades de tempo (no mínimo) o estado de algum terminal
+//   pode mudar, ou 0 se nenhum vai mudar sozinho (ver terminal_tics_ate_evento)
+int console_tics_ate_evento(console_t *self);
+
+// lê o teclado e redesenha a tela
+// deve ser chamada periodicamente (em tempo real, não precisa ser a cada
+//   instrução); não faz nada no modo lote
+void console_atualiza_tela(console_t *self);
+
 // esta função deve ser chamada periodicamente para que tela funcione
+// equivale a console_tictac_terminais seguida de console_atualiza_tela
 void console_tictac(console_t *self);
 
 #endif // CONSOLE_H
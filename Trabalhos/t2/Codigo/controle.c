@@ -9,65 +9,611 @@
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+// número de unidades de tempo executadas em seguida, sem olhar a console,
+//   quando em execução contínua
+#define INSTRUCOES_POR_LOTE 1000
+// intervalo mínimo entre atualizações da tela, em ms de tempo real
+#define PERIODO_ATUALIZACAO_TELA 50
+
+// modo paralelo: a thread de uma CPU, e a disputa dela pela trava do SO
+typedef struct {
+  controle_t *controle;
+  int id;
+  pthread_t thread;
+  // entradas no SO, quantas encontraram a trava ocupada, e o tempo real
+  //   esperando por ela (e pelo acesso exclusivo ao barramento), em ns
+  int entradas_so;
+  int esperas_so;
+  long espera_ns;
+} controle_fio_t;
 
 struct controle_t {
-  cpu_t *cpu;
+  int n_cpus;
+  cpu_t **cpus;
+  // quantas unidades de tempo cada CPU executou além do tempo dos
+  //   dispositivos (só a que ficou mais para trás define quanto o tempo anda)
+  int *adiantamento;
+  // caixas de correio de cada CPU: interrupção do relógio e interrupção entre
+  //   processadores ainda não aceitas por ela; no modo paralelo são escritas
+  //   por outras threads sem trava, e esvaziadas pela thread da CPU
+  atomic_bool *int_relogio;
+  atomic_bool *int_ipi;
+  // interrupção do disco ainda não aceita por nenhuma CPU
+  bool int_disco;
   relogio_t *relogio;
+  ctrl_disco_t *disco;
   console_t *console;
   enum { executando, passo, parado, fim } estado;
+  // modo lote: não tem operador, executa até não ter mais o que fazer
+  bool lote;
+  // momento da última atualização da tela, em ms de tempo real
+  long ultima_atualizacao;
+
+  // modo paralelo: uma thread por CPU
+  bool paralelo;
+  controle_fio_t *fios;
+  // só uma CPU executa o SO de cada vez
+  pthread_mutex_t trava_so;
+  // memória, MMUs e tabelas de páginas: as CPUs executam instruções com
+  //   acesso compartilhado, e o SO com acesso exclusivo, porque mexe no que
+  //   as outras CPUs estão usando; a catraca impede que CPUs continuem
+  //   entrando enquanto o SO espera pelo acesso exclusivo
+  pthread_rwlock_t barramento;
+  pthread_mutex_t catraca;
+  // tempo, dispositivos e interrupções pedidas por eles; 'mudou' acorda as
+  //   CPUs que esperam o tempo andar ou uma interrupção chegar
+  pthread_mutex_t trava_disp;
+  pthread_cond_t mudou;
+  // CPUs paradas, que não seguram o tempo
+  bool *parada;
 };
 
 // funções auxiliares
+static int controle_executa_bloco(controle_t *self, int max);
+static void controle_executa_lote(controle_t *self);
+static bool controle_cpu_parada_para_sempre(controle_t *self);
+static long controle_tempo_real_ms(void);
+static void controle_atualiza_tela(controle_t *self);
 static void controle_processa_comandos_da_console(controle_t *self);
 static void controle_atualiza_estado_na_console(controle_t *self);
+static void controle_laco_paralelo(controle_t *self);
 
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio)
+controle_t *controle_cria(int n_cpus, cpu_t *cpus[n_cpus], console_t *console,
+                          relogio_t *relogio, ctrl_disco_t *disco, bool lote,
+                          bool paralelo)
 {
   controle_t *self = malloc(sizeof(*self));
   assert(self != NULL);
 
-  self->cpu = cpu;
+  self->n_cpus = n_cpus;
+  self->cpus = malloc(n_cpus * sizeof(*self->cpus));
+  self->adiantamento = malloc(n_cpus * sizeof(*self->adiantamento));
+  self->int_relogio = malloc(n_cpus * sizeof(*self->int_relogio));
+  self->int_ipi = malloc(n_cpus * sizeof(*self->int_ipi));
+  self->fios = malloc(n_cpus * sizeof(*self->fios));
+  self->parada = malloc(n_cpus * sizeof(*self->parada));
+  assert(self->cpus != NULL && self->adiantamento != NULL
+         && self->int_relogio != NULL && self->int_ipi != NULL
+         && self->fios != NULL && self->parada != NULL);
+  for (int i = 0; i < n_cpus; i++) {
+    self->cpus[i] = cpus[i];
+    self->adiantamento[i] = 0;
+    atomic_init(&self->int_relogio[i], false);
+    atomic_init(&self->int_ipi[i], false);
+    self->fios[i] = (controle_fio_t){ .controle = self, .id = i };
+    self->parada[i] = false;
+  }
+  self->int_disco = false;
   self->console = console;
   self->relogio = relogio;
-  self->estado = parado;
+  self->disco = disco;
+  self->lote = lote;
+  // no modo lote não tem operador para mandar executar
+  self->estado = lote ? executando : parado;
+  self->ultima_atualizacao = 0;
+  self->paralelo = paralelo;
+  pthread_mutex_init(&self->trava_so, NULL);
+  pthread_rwlock_init(&self->barramento, NULL);
+  pthread_mutex_init(&self->catraca, NULL);
+  pthread_mutex_init(&self->trava_disp, NULL);
+  pthread_cond_init(&self->mudou, NULL);
 
   return self;
 }
 
 void controle_destroi(controle_t *self)
 {
+  pthread_mutex_destroy(&self->trava_so);
+  pthread_rwlock_destroy(&self->barramento);
+  pthread_mutex_destroy(&self->catraca);
+  pthread_mutex_destroy(&self->trava_disp);
+  pthread_cond_destroy(&self->mudou);
+  free(self->cpus);
+  free(self->adiantamento);
+  free(self->int_relogio);
+  free(self->int_ipi);
+  free(self->fios);
+  free(self->parada);
   free(self);
 }
 
 void controle_laco(controle_t *self)
 {
-  // executa uma instrução por vez até a console dizer que chega
+  if (self->paralelo) {
+    controle_laco_paralelo(self);
+    return;
+  }
+
+  // executa instruções até a console dizer que chega (ou, no modo lote, até
+  //   não ter mais nada para executar)
+  // em execução contínua, as instruções são executadas em lotes, e a tela só é
+  //   redesenhada a cada PERIODO_ATUALIZACAO_TELA ms
   do {
-    if (self->estado == passo || self->estado == executando) {
-      cpu_executa_1(self->cpu);
-      relogio_tictac(self->relogio);
-
-      if (self->estado == passo) self->estado = parado;
-
-      // enquanto não tem controlador de interrupção, fala direto com o relógio
-      // o dispositivo 3 do relógio contém 1 se o timer expirou
-      int tem_int;
-      relogio_leitura(self->relogio, 3, &tem_int);
-      if (tem_int != 0) {
-        cpu_interrompe(self->cpu, IRQ_RELOGIO);
-      }
+    if (self->estado == executando) {
+      controle_executa_lote(self);
+    } else if (self->estado == passo) {
+      controle_executa_bloco(self, 1);
+      self->estado = parado;
     }
-    console_tictac(self->console);
 
-    controle_processa_comandos_da_console(self);
-    controle_atualiza_estado_na_console(self);
+    if (self->lote) {
+      if (controle_cpu_parada_para_sempre(self)) self->estado = fim;
+    } else if (self->estado != executando
+               || controle_tempo_real_ms() - self->ultima_atualizacao
+                  >= PERIODO_ATUALIZACAO_TELA) {
+      controle_atualiza_tela(self);
+    }
   } while (self->estado != fim);
 
   console_printf("Fim da execução.");
   console_printf("relógio: %d\n", relogio_agora(self->relogio));
 }
- 
+
+// retorna o menor de dois tempos até eventos, onde 0 é "sem evento"
+static int controle_primeiro_evento(int t1, int t2)
+{
+  if (t1 == 0) return t2;
+  if (t2 == 0) return t1;
+  return t1 < t2 ? t1 : t2;
+}
+
+// retorna em quantas unidades de tempo acontece o próximo evento que pode
+//   causar uma interrupção (o timer expirar, o disco terminar um pedido ou
+//   algum terminal mudar de estado), ou 0 se não tem evento previsto
+static int controle_tics_ate_evento(controle_t *self)
+{
+  int t_timer = relogio_tics_ate_interrupcao(self->relogio);
+  int t_disco = ctrl_disco_tics_ate_interrupcao(self->disco);
+  int t_term = console_tics_ate_evento(self->console);
+  return controle_primeiro_evento(controle_primeiro_evento(t_timer, t_disco),
+                                  t_term);
+}
+
+// retorna true se algum dispositivo está pedindo interrupção, ou se tem
+//   interrupção ainda não aceita por alguma CPU
+static bool controle_tem_interrupcao_pendente(controle_t *self)
+{
+  // o dispositivo 3 do relógio contém 1 se o timer expirou
+  int tem_int;
+  relogio_leitura(self->relogio, 3, &tem_int);
+  if (tem_int != 0 || self->int_disco) return true;
+  for (int i = 0; i < self->n_cpus; i++) {
+    if (self->int_relogio[i] || self->int_ipi[i]) return true;
+  }
+  return ctrl_disco_pede_interrupcao(self->disco)
+         || console_pede_interrupcao(self->console, IRQ_TECLADO)
+         || console_pede_interrupcao(self->console, IRQ_TELA);
+}
+
+// faz o tempo passar nos dispositivos
+// quando o relógio ou o disco passa a pedir interrupção, registra o pedido
+//   para ser entregue: o do relógio a todas as CPUs, o do disco a uma
+static void controle_avanca_dispositivos(controle_t *self, int tics)
+{
+  int antes;
+  relogio_leitura(self->relogio, 3, &antes);
+  relogio_avanca(self->relogio, tics);
+  int depois;
+  relogio_leitura(self->relogio, 3, &depois);
+  if (antes == 0 && depois != 0) {
+    for (int i = 0; i < self->n_cpus; i++) {
+      self->int_relogio[i] = true;
+    }
+  }
+
+  bool disco_antes = ctrl_disco_pede_interrupcao(self->disco);
+  ctrl_disco_avanca(self->disco, tics);
+  if (!disco_antes && ctrl_disco_pede_interrupcao(self->disco)) {
+    self->int_disco = true;
+  }
+
+  console_avanca_terminais(self->console, tics);
+}
+
+// tenta entregar a interrupção 'irq' (do disco ou de um terminal) para uma
+//   CPU que ainda não aceitou nenhuma nesta rodada, de preferência uma que
+//   esteja parada; retorna true se alguma aceitou
+static bool controle_entrega_a_uma_cpu(controle_t *self, irq_t irq,
+                                       bool aceitou[])
+{
+  for (int parada = 1; parada >= 0; parada--) {
+    for (int i = 0; i < self->n_cpus; i++) {
+      if (aceitou[i] || cpu_parada(self->cpus[i]) != parada) continue;
+      if (cpu_interrompe(self->cpus[i], irq)) {
+        aceitou[i] = true;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// repassa para as CPUs os pedidos de interrupção dos dispositivos, em ordem
+//   de prioridade; cada CPU aceita no máximo um (depois passa a modo
+//   supervisor)
+// os pedidos do relógio e do disco só são desligados pelo SO; os dos terminais
+//   são desligados quando uma CPU aceita a interrupção
+static void controle_pede_interrupcoes(controle_t *self)
+{
+  // enquanto não tem controlador de interrupção, fala direto com os dispositivos
+  // a interrupção pedida por outra CPU vem antes das outras: ela não é
+  //   desligada pelo SO, e não pode ficar esperando
+  bool aceitou[self->n_cpus];
+  for (int i = 0; i < self->n_cpus; i++) {
+    aceitou[i] = self->int_ipi[i] && cpu_interrompe(self->cpus[i], IRQ_IPI);
+    if (aceitou[i]) {
+      self->int_ipi[i] = false;
+      continue;
+    }
+    aceitou[i] = self->int_relogio[i]
+                 && cpu_interrompe(self->cpus[i], IRQ_RELOGIO);
+    if (aceitou[i]) self->int_relogio[i] = false;
+  }
+  if (self->int_disco
+      && controle_entrega_a_uma_cpu(self, IRQ_DISCO, aceitou)) {
+    self->int_disco = false;
+  }
+
+  irq_t irqs_terminal[] = { IRQ_TECLADO, IRQ_TELA };
+  for (int i = 0; i < 2; i++) {
+    irq_t irq = irqs_terminal[i];
+    if (console_pede_interrupcao(self->console, irq)
+        && controle_entrega_a_uma_cpu(self, irq, aceitou)) {
+      console_atende_interrupcao(self->console, irq);
+    }
+  }
+}
+
+err_t controle_escrita_ipi(void *disp, int id, int valor)
+{
+  controle_t *self = disp;
+  if (id != 0) return ERR_END_INV;
+  if (valor < 0 || valor >= self->n_cpus) return ERR_OP_INV;
+  self->int_ipi[valor] = true;
+  // a CPU pode estar parada, esperando alguma coisa mudar
+  if (self->paralelo) {
+    pthread_mutex_lock(&self->trava_disp);
+    pthread_cond_broadcast(&self->mudou);
+    pthread_mutex_unlock(&self->trava_disp);
+  }
+  return ERR_OK;
+}
+
+// executa até 'max' instruções de uma vez e faz passar nos dispositivos o
+//   tempo correspondente; se as CPUs estão paradas, faz o tempo passar até o
+//   próximo evento, mesmo que isso seja mais que 'max'
+// o bloco não vai além do próximo evento que pode causar interrupção, e tem
+//   uma só instrução se já tem interrupção pendente, para que ela seja aceita
+//   assim que a CPU puder
+// cada CPU executa até ficar 'max' à frente dos dispositivos, mas pode parar
+//   antes (numa chamada ao SO, por exemplo); o tempo anda o que andou a CPU
+//   que ficou mais para trás, e as outras ficam adiantadas para o próximo bloco
+// retorna o número de unidades de tempo que passaram
+static int controle_executa_bloco(controle_t *self, int max)
+{
+  bool pendente = controle_tem_interrupcao_pendente(self);
+  int t_evento = controle_tics_ate_evento(self);
+  int n = max;
+  if (t_evento != 0 && t_evento < n) n = t_evento;
+  if (pendente) n = 1;
+
+  int tics = 0;
+  for (int i = 0; i < self->n_cpus; i++) {
+    int executadas = 0;
+    if (self->adiantamento[i] < n) {
+      executadas = cpu_executa_n(self->cpus[i], n - self->adiantamento[i]);
+      self->adiantamento[i] += executadas;
+    }
+    // uma CPU parada não segura o tempo
+    if (executadas == 0 && cpu_parada(self->cpus[i])) continue;
+    if (tics == 0 || self->adiantamento[i] < tics) {
+      tics = self->adiantamento[i];
+    }
+  }
+  if (tics == 0) {
+    // com as CPUs paradas, nada acontece até o próximo evento; o tempo avança
+    //   direto até lá
+    tics = (t_evento != 0 && !pendente) ? t_evento : 1;
+  }
+  for (int i = 0; i < self->n_cpus; i++) {
+    self->adiantamento[i] -= tics;
+    if (self->adiantamento[i] < 0 || cpu_parada(self->cpus[i])) {
+      self->adiantamento[i] = 0;
+    }
+  }
+  controle_avanca_dispositivos(self, tics);
+
+  controle_pede_interrupcoes(self);
+  return tics;
+}
+
+// executa até INSTRUCOES_POR_LOTE unidades de tempo sem passar pela console
+static void controle_executa_lote(controle_t *self)
+{
+  int tics = 0;
+  while (tics < INSTRUCOES_POR_LOTE && !controle_cpu_parada_para_sempre(self)) {
+    tics += controle_executa_bloco(self, INSTRUCOES_POR_LOTE - tics);
+  }
+}
+
+// retorna true se as CPUs estão paradas e não tem interrupção que as faça
+//   voltar a executar (o SO desligou o timer antes de parar, e os terminais
+//   não vão mais mudar de estado)
+static bool controle_cpu_parada_para_sempre(controle_t *self)
+{
+  for (int i = 0; i < self->n_cpus; i++) {
+    if (!cpu_parada(self->cpus[i])) return false;
+  }
+  return !controle_tem_interrupcao_pendente(self)
+         && controle_tics_ate_evento(self) == 0;
+}
+
+// MODO PARALELO
+// cada CPU executa na sua thread; o tempo dos dispositivos anda como no modo
+//   intercalado: com o que andou a CPU que ficou mais para trás, e nenhuma
+//   fica mais de um bloco à frente dele
+// ordem das travas: trava_so, catraca, barramento, trava_disp
+
+// obtém acesso compartilhado ao barramento, para executar instruções
+static void controle_acessa_barramento(controle_t *self)
+{
+  pthread_mutex_lock(&self->catraca);
+  pthread_rwlock_rdlock(&self->barramento);
+  pthread_mutex_unlock(&self->catraca);
+}
+
+static long controle_tempo_real_ns(void)
+{
+  struct timespec agora;
+  clock_gettime(CLOCK_MONOTONIC, &agora);
+  return agora.tv_sec * 1000000000L + agora.tv_nsec;
+}
+
+// a CPU do fio vai executar o SO: pega a trava do SO e o acesso exclusivo ao
+//   barramento, contando quando a trava estava ocupada e o tempo esperando
+static void controle_entra_no_so(controle_t *self, controle_fio_t *fio)
+{
+  long inicio = controle_tempo_real_ns();
+  if (pthread_mutex_trylock(&self->trava_so) != 0) {
+    fio->esperas_so++;
+    pthread_mutex_lock(&self->trava_so);
+  }
+  pthread_mutex_lock(&self->catraca);
+  pthread_rwlock_wrlock(&self->barramento);
+  pthread_mutex_unlock(&self->catraca);
+  fio->espera_ns += controle_tempo_real_ns() - inicio;
+  fio->entradas_so++;
+}
+
+static void controle_sai_do_so(controle_t *self)
+{
+  pthread_rwlock_unlock(&self->barramento);
+  pthread_mutex_unlock(&self->trava_so);
+}
+
+// entrega à CPU 'i' um pedido de interrupção pendente que ela possa aceitar:
+//   das suas caixas de correio ou, se nenhuma outra CPU estiver parada (essas
+//   têm preferência), do disco ou de um terminal
+// chamada pela thread da CPU, com acesso ao barramento e a trava_disp
+static void controle_entrega_a_cpu(controle_t *self, int i)
+{
+  cpu_t *cpu = self->cpus[i];
+  if (atomic_exchange(&self->int_ipi[i], false)) {
+    if (cpu_interrompe(cpu, IRQ_IPI)) return;
+    self->int_ipi[i] = true;
+  }
+  if (atomic_exchange(&self->int_relogio[i], false)) {
+    if (cpu_interrompe(cpu, IRQ_RELOGIO)) return;
+    self->int_relogio[i] = true;
+  }
+
+  if (!cpu_parada(cpu)) {
+    for (int j = 0; j < self->n_cpus; j++) {
+      if (j != i && self->parada[j]) return;
+    }
+  }
+  if (self->int_disco && cpu_interrompe(cpu, IRQ_DISCO)) {
+    self->int_disco = false;
+    return;
+  }
+  irq_t irqs_terminal[] = { IRQ_TECLADO, IRQ_TELA };
+  for (int t = 0; t < 2; t++) {
+    if (console_pede_interrupcao(self->console, irqs_terminal[t])
+        && cpu_interrompe(cpu, irqs_terminal[t])) {
+      console_atende_interrupcao(self->console, irqs_terminal[t]);
+      return;
+    }
+  }
+}
+
+// faz o tempo andar o que andou a CPU não parada que ficou mais para trás, e
+//   acorda quem espera por isso
+// chamada com acesso ao barramento e a trava_disp
+static void controle_avanca_tempo(controle_t *self)
+{
+  int tics = 0;
+  bool alguma = false;
+  for (int i = 0; i < self->n_cpus; i++) {
+    if (self->parada[i]) continue;
+    if (!alguma || self->adiantamento[i] < tics) tics = self->adiantamento[i];
+    alguma = true;
+  }
+  if (tics <= 0) return;
+
+  for (int i = 0; i < self->n_cpus; i++) {
+    if (!self->parada[i]) self->adiantamento[i] -= tics;
+  }
+  controle_avanca_dispositivos(self, tics);
+  pthread_cond_broadcast(&self->mudou);
+}
+
+// com todas as CPUs paradas, nada acontece até o próximo evento: avança o
+//   tempo direto até lá, ou termina a simulação se não tem evento nem
+//   interrupção pendente; retorna true se tem interrupção esperando para ser
+//   aceita por alguma CPU
+// chamada com acesso ao barramento e a trava_disp
+static bool controle_avanca_com_cpus_paradas(controle_t *self)
+{
+  bool pendente = controle_tem_interrupcao_pendente(self);
+  int t_evento = controle_tics_ate_evento(self);
+  if (!pendente && t_evento == 0) {
+    self->estado = fim;
+  } else if (!pendente) {
+    controle_avanca_dispositivos(self, t_evento);
+  }
+  pthread_cond_broadcast(&self->mudou);
+  return pendente;
+}
+
+// quantas instruções a CPU 'i' pode executar agora: até ficar um bloco à
+//   frente do tempo dos dispositivos, sem passar do próximo evento, ou uma só
+//   se tem interrupção pendente (como em controle_executa_bloco); 0 se está
+//   parada ou já está à frente demais
+// chamada com acesso ao barramento e a trava_disp
+static int controle_tam_bloco(controle_t *self, int i)
+{
+  if (self->parada[i]) return 0;
+  int n = INSTRUCOES_POR_LOTE;
+  int t_evento = controle_tics_ate_evento(self);
+  if (t_evento != 0 && t_evento < n) n = t_evento;
+  if (controle_tem_interrupcao_pendente(self)) n = 1;
+  return n - self->adiantamento[i];
+}
+
+// o laço da thread de uma CPU
+static void *controle_executa_cpu(void *arg)
+{
+  controle_fio_t *fio = arg;
+  controle_t *self = fio->controle;
+  int i = fio->id;
+  cpu_t *cpu = self->cpus[i];
+
+  for (;;) {
+    controle_acessa_barramento(self);
+    pthread_mutex_lock(&self->trava_disp);
+    controle_entrega_a_cpu(self, i);
+    self->parada[i] = cpu_parada(cpu);
+    int n = 0;
+    if (self->parada[i]) {
+      // a CPU parada não segura o tempo, que pode andar para as outras; a
+      //   última a parar faz ele andar até o próximo evento
+      self->adiantamento[i] = 0;
+      controle_avanca_tempo(self);
+      bool todas = true;
+      for (int j = 0; j < self->n_cpus; j++) {
+        if (!self->parada[j]) todas = false;
+      }
+      if (todas && !controle_avanca_com_cpus_paradas(self)) n = -1;
+    } else {
+      n = controle_tam_bloco(self, i);
+    }
+    if (self->estado == fim) {
+      pthread_mutex_unlock(&self->trava_disp);
+      pthread_rwlock_unlock(&self->barramento);
+      break;
+    }
+    if (n < 0) {
+      // o tempo andou até o próximo evento; vê de novo se tem interrupção
+      pthread_mutex_unlock(&self->trava_disp);
+      pthread_rwlock_unlock(&self->barramento);
+      continue;
+    }
+    if (n == 0) {
+      // parada, ou à frente demais: espera o tempo andar ou chegar uma
+      //   interrupção (sem o barramento, que o SO pode precisar)
+      pthread_rwlock_unlock(&self->barramento);
+      pthread_cond_wait(&self->mudou, &self->trava_disp);
+      pthread_mutex_unlock(&self->trava_disp);
+      continue;
+    }
+    pthread_mutex_unlock(&self->trava_disp);
+
+    int executadas;
+    if (cpu_entrando_no_tratador(cpu)) {
+      // a próxima instrução é o CHAMAC, que executa o SO
+      pthread_rwlock_unlock(&self->barramento);
+      controle_entra_no_so(self, fio);
+      executadas = cpu_executa_n(cpu, 1);
+      controle_sai_do_so(self);
+      controle_acessa_barramento(self);
+    } else {
+      executadas = cpu_executa_n(cpu, n);
+    }
+
+    pthread_mutex_lock(&self->trava_disp);
+    self->adiantamento[i] += executadas;
+    controle_avanca_tempo(self);
+    pthread_mutex_unlock(&self->trava_disp);
+    pthread_rwlock_unlock(&self->barramento);
+  }
+  return NULL;
+}
+
+// executa as CPUs em paralelo até a simulação terminar, e mostra a disputa
+//   pela trava do SO
+static void controle_laco_paralelo(controle_t *self)
+{
+  for (int i = 0; i < self->n_cpus; i++) {
+    if (pthread_create(&self->fios[i].thread, NULL, controle_executa_cpu,
+                       &self->fios[i]) != 0) {
+      fprintf(stderr, "ERRO: não foi possível criar a thread da CPU %d\n", i);
+      exit(1);
+    }
+  }
+  for (int i = 0; i < self->n_cpus; i++) {
+    pthread_join(self->fios[i].thread, NULL);
+  }
+
+  console_printf("Trava do SO (modo paralelo):");
+  for (int i = 0; i < self->n_cpus; i++) {
+    controle_fio_t *fio = &self->fios[i];
+    console_printf("-> CPU %d: %d entradas no SO, %d com a trava ocupada, %.3f ms esperando",
+                   i, fio->entradas_so, fio->esperas_so, fio->espera_ns / 1e6);
+  }
+  console_printf("Fim da execução.");
+  console_printf("relógio: %d\n", relogio_agora(self->relogio));
+}
+
+static long controle_tempo_real_ms(void)
+{
+  struct timespec agora;
+  clock_gettime(CLOCK_MONOTONIC, &agora);
+  return agora.tv_sec * 1000L + agora.tv_nsec / 1000000;
+}
+
+static void controle_atualiza_tela(controle_t *self)
+{
+  console_atualiza_tela(self->console);
+  controle_processa_comandos_da_console(self);
+  controle_atualiza_estado_na_console(self);
+  self->ultima_atualizacao = controle_tempo_real_ms();
+}
+
 
 static void controle_processa_comandos_da_console(controle_t *self)
 {
@@ -97,6 +643,7 @@ static void controle_atualiza_estado_na_console(controle_t *self)
     case executando: strcpy(status, "EXEC   | "); break;
     case passo:      strcpy(status, "PASSO  | "); break;
   }
-  cpu_concatena_descricao(self->cpu, status);
+  // só cabe a descrição de uma CPU
+  cpu_concatena_descricao(self->cpus[0], status);
   console_print_status(self->console, status);
 }
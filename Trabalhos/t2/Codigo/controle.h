@@ -11,11 +11,35 @@ typedef struct controle_t controle_t;
 #include "cpu.h"
 #include "console.h"
 #include "relogio.h"
+#include "ctrl_disco.h"
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio);
+#include <stdbool.h>
+
+// cria o controlador, para 'n_cpus' CPUs que compartilham a memória e os
+//   dispositivos
+// as CPUs não executam em paralelo de verdade: o controlador intercala a
+//   execução delas, de forma que nenhuma fique mais de um bloco de instruções
+//   à frente das outras; a simulação continua determinística
+// a interrupção do relógio vai para todas as CPUs; as outras vão para uma só,
+//   de preferência uma que esteja parada
+// se 'lote' for true, executa sem esperar comandos do operador, e termina a
+//   simulação quando as CPUs estiverem paradas sem nenhuma interrupção pendente
+// se 'paralelo' for true (só no modo lote), cada CPU executa na sua thread, de
+//   verdade em paralelo, e a simulação deixa de ser determinística: as CPUs
+//   executam as instruções de usuário ao mesmo tempo, e o SO é executado por
+//   uma de cada vez, sob uma trava, com as outras paradas entre instruções
+controle_t *controle_cria(int n_cpus, cpu_t *cpus[n_cpus], console_t *console,
+                          relogio_t *relogio, ctrl_disco_t *disco, bool lote,
+                          bool paralelo);
 void controle_destroi(controle_t *self);
 
 // o laço principal da simulação
 void controle_laco(controle_t *self);
 
+// função para acessar o controlador como dispositivo de E/S (D_IPI): escrever
+//   o número de uma CPU pede uma interrupção IRQ_IPI para ela, que é entregue
+//   quando a CPU puder aceitar (no modo paralelo, pela thread dela)
+// segue o protocolo f_escrita_t declarado em es.h
+err_t controle_escrita_ipi(void *disp, int id, int valor);
+
 #endif // CONTROLE_H
@@ -16,6 +16,20 @@
 #include <assert.h>
 
 // DECLARAÇÃO {{{1
+
+// tipo das funções que implementam cada instrução
+typedef void (*operacao_t)(cpu_t *self, int A1);
+
+// uma instrução já decodificada: o opcode, o argumento (se tiver) e a função
+//   que a implementa
+typedef struct {
+  bool valida;
+  bool privilegiada;
+  int opcode;
+  int A1;
+  operacao_t op;
+} instr_decod_t;
+
 // uma CPU tem estado, memória, controlador de ES
 struct cpu_t {
   // registradores
@@ -31,13 +45,24 @@ struct cpu_t {
   es_t *es;
   // identificação das instruções privilegiadas
   bool privilegiadas[N_OPCODE];
+  // número de argumentos de cada instrução
+  int num_args[N_OPCODE];
+  // instruções decodificadas, indexadas pelo endereço físico do opcode
+  // uma entrada deixa de ser válida quando a memória é alterada no endereço
+  //   dela ou no seguinte (ver cpu_memoria_alterada)
+  int tam_decod;
+  instr_decod_t *decod;
   // função e argumento para implementar instrução CHAMAC
   func_chamaC_t funcaoC;
   void *argC;
+  // endereço onde o estado é salvo na interrupção
+  int area_irq;
+  // contador de instruções executadas (nos dois modos)
+  int instrucoes_executadas;
 };
 
 // CRIAÇÃO {{{1
-cpu_t *cpu_cria(mmu_t *mmu, es_t *es)
+cpu_t *cpu_cria(mmu_t *mmu, es_t *es, int area_irq)
 {
   cpu_t *self;
   self = malloc(sizeof(*self));
@@ -45,6 +70,7 @@ cpu_t *cpu_cria(mmu_t *mmu, es_t *es)
 
   self->mmu = mmu;
   self->es = es;
+  self->area_irq = area_irq;
   // inicializa registradores
   self->PC = 0;
   self->A = 0;
@@ -53,6 +79,7 @@ cpu_t *cpu_cria(mmu_t *mmu, es_t *es)
   self->complemento = 0;
   self->modo = usuario;
   self->funcaoC = NULL;
+  self->instrucoes_executadas = 0;
   // inicializa instruções privilegiadas
   memset(self->privilegiadas, 0, sizeof(self->privilegiadas));
   self->privilegiadas[PARA] = true;
@@ -60,6 +87,14 @@ cpu_t *cpu_cria(mmu_t *mmu, es_t *es)
   self->privilegiadas[ESCR] = true;
   self->privilegiadas[RETI] = true;
   self->privilegiadas[CHAMAC] = true;
+  // inicializa o número de argumentos, para a decodificação
+  for (int opcode = 0; opcode < N_OPCODE; opcode++) {
+    self->num_args[opcode] = instrucao_num_args(opcode);
+  }
+  // inicializa a cache de instruções decodificadas, toda inválida
+  self->tam_decod = mmu_tam_mem(mmu);
+  self->decod = calloc(self->tam_decod, sizeof(*self->decod));
+  assert(self->decod != NULL);
   // gera uma interrupção de reset, para o SO poder executar
   cpu_interrompe(self, IRQ_RESET);
 
@@ -69,9 +104,15 @@ cpu_t *cpu_cria(mmu_t *mmu, es_t *es)
 void cpu_destroi(cpu_t *self)
 {
   // eu nao criei MMU nem es; quem criou que destrua!
+  free(self->decod);
   free(self);
 }
 
+int cpu_area_irq(cpu_t *self)
+{
+  return self->area_irq;
+}
+
 void cpu_define_chamaC(cpu_t *self, func_chamaC_t funcaoC, void *argC)
 {
   self->funcaoC = funcaoC;
@@ -142,26 +183,6 @@ static bool pega_mem(cpu_t *self, int endereco, int *pval)
   return false;
 }
 
-// lê o opcode da instrução no PC
-// retorna true se ele pode ser executado, ou põe em erro o motivo de não poder
-static bool pega_opcode(cpu_t *self, int *popc)
-{
-  // não tem que testar endereços, é tarefa da mmu
-  // não pode executar se houver erro na leitura da memória
-  if (!pega_mem(self, self->PC, popc)) return false;
-  // pode executar se tiver privilégio para isso
-  if (self->modo == supervisor || !self->privilegiadas[*popc]) return true;
-  // não pode executar instrução privilegiada em modo usuário
-  self->erro = ERR_INSTR_PRIV;
-  return false;
-}
-
-// lê o argumento 1 da instrução no PC
-static bool pega_A1(cpu_t *self, int *pA1)
-{
-  return pega_mem(self, self->PC + 1, pA1);
-}
-
 // escreve um valor na memória
 static bool poe_mem(cpu_t *self, int endereco, int val)
 {
@@ -192,63 +213,60 @@ static bool poe_es(cpu_t *self, int dispositivo, int val)
 // INSTRUÇÕES {{{1
 // ---------------------------------------------------------------------
 // funções auxiliares para implementação de cada instrução
+// todas recebem o argumento A1 da instrução, que já foi buscado na memória
+//   (e não deve ser usado pelas instruções que não têm argumento)
 
-static void op_NOP(cpu_t *self) // não faz nada
+static void op_NOP(cpu_t *self, int A1) // não faz nada
 {
   self->PC += 1;
 }
 
-static void op_PARA(cpu_t *self) // para a CPU
+static void op_PARA(cpu_t *self, int A1) // para a CPU
 {
   self->erro = ERR_CPU_PARADA;
 }
 
-static void op_CARGI(cpu_t *self) // carrega imediato
+static void op_CARGI(cpu_t *self, int A1) // carrega imediato
 {
-  int A1;
-  if (pega_A1(self, &A1)) {
-    self->A = A1;
-    self->PC += 2;
-  }
+  self->A = A1;
+  self->PC += 2;
 }
 
-static void op_CARGM(cpu_t *self) // carrega da memória
+static void op_CARGM(cpu_t *self, int A1) // carrega da memória
 {
-  int A1, mA1;
-  if (pega_A1(self, &A1) && pega_mem(self, A1, &mA1)) {
+  int mA1;
+  if (pega_mem(self, A1, &mA1)) {
     self->A = mA1;
     self->PC += 2;
   }
 }
 
-static void op_CARGX(cpu_t *self) // carrega indexado
+static void op_CARGX(cpu_t *self, int A1) // carrega indexado
 {
-  int A1, mA1mX;
+  int mA1mX;
   int X = self->X;
-  if (pega_A1(self, &A1) && pega_mem(self, A1 + X, &mA1mX)) {
+  if (pega_mem(self, A1 + X, &mA1mX)) {
     self->A = mA1mX;
     self->PC += 2;
   }
 }
 
-static void op_ARMM(cpu_t *self) // armazena na memória
+static void op_ARMM(cpu_t *self, int A1) // armazena na memória
 {
-  int A1;
-  if (pega_A1(self, &A1) && poe_mem(self, A1, self->A)) {
+  if (poe_mem(self, A1, self->A)) {
     self->PC += 2;
   }
 }
 
-static void op_ARMX(cpu_t *self) // armazena indexado
+static void op_ARMX(cpu_t *self, int A1) // armazena indexado
 {
-  int A1;
   int X = self->X;
-  if (pega_A1(self, &A1) && poe_mem(self, A1 + X, self->A)) {
+  if (poe_mem(self, A1 + X, self->A)) {
     self->PC += 2;
   }
 }
 
-static void op_TRAX(cpu_t *self) // troca A com X
+static void op_TRAX(cpu_t *self, int A1) // troca A com X
 {
   int A = self->A;
   int X = self->X;
@@ -257,142 +275,137 @@ static void op_TRAX(cpu_t *self) // troca A com X
   self->PC += 1;
 }
 
-static void op_CPXA(cpu_t *self) // copia X para A
+static void op_CPXA(cpu_t *self, int A1) // copia X para A
 {
   self->A = self->X;
   self->PC += 1;
 }
 
-static void op_INCX(cpu_t *self) // incrementa X
+static void op_INCX(cpu_t *self, int A1) // incrementa X
 {
   self->X += 1;
   self->PC += 1;
 }
 
-static void op_SOMA(cpu_t *self) // soma
+static void op_SOMA(cpu_t *self, int A1) // soma
 {
-  int A1, mA1;
-  if (pega_A1(self, &A1) && pega_mem(self, A1, &mA1)) {
+  int mA1;
+  if (pega_mem(self, A1, &mA1)) {
     self->A += mA1;
     self->PC += 2;
   }
 }
 
-static void op_SUB(cpu_t *self) // subtração
+static void op_SUB(cpu_t *self, int A1) // subtração
 {
-  int A1, mA1;
-  if (pega_A1(self, &A1) && pega_mem(self, A1, &mA1)) {
+  int mA1;
+  if (pega_mem(self, A1, &mA1)) {
     self->A -= mA1;
     self->PC += 2;
   }
 }
 
-static void op_MULT(cpu_t *self) // multiplicação
+static void op_MULT(cpu_t *self, int A1) // multiplicação
 {
-  int A1, mA1;
-  if (pega_A1(self, &A1) && pega_mem(self, A1, &mA1)) {
+  int mA1;
+  if (pega_mem(self, A1, &mA1)) {
     self->A *= mA1;
     self->PC += 2;
   }
 }
 
-static void op_DIV(cpu_t *self) // divisão
+static void op_DIV(cpu_t *self, int A1) // divisão
 {
-  int A1, mA1;
-  if (pega_A1(self, &A1) && pega_mem(self, A1, &mA1)) {
+  int mA1;
+  if (pega_mem(self, A1, &mA1)) {
     self->A /= mA1;
     self->PC += 2;
   }
 }
 
-static void op_RESTO(cpu_t *self) // resto
+static void op_RESTO(cpu_t *self, int A1) // resto
 {
-  int A1, mA1;
-  if (pega_A1(self, &A1) && pega_mem(self, A1, &mA1)) {
+  int mA1;
+  if (pega_mem(self, A1, &mA1)) {
     self->A %= mA1;
     self->PC += 2;
   }
 }
 
-static void op_NEG(cpu_t *self) // inverte sinal
+static void op_NEG(cpu_t *self, int A1) // inverte sinal
 {
   self->A = -self->A;
   self->PC += 1;
 }
 
-static void op_DESV(cpu_t *self) // desvio incondicional
+static void op_DESV(cpu_t *self, int A1) // desvio incondicional
 {
-  int A1;
-  if (pega_A1(self, &A1)) {
-    self->PC = A1;
-  }
+  self->PC = A1;
 }
 
-static void op_DESVZ(cpu_t *self) // desvio condicional
+static void op_DESVZ(cpu_t *self, int A1) // desvio condicional
 {
   if (self->A == 0) {
-    op_DESV(self);
+    op_DESV(self, A1);
   } else {
     self->PC += 2;
   }
 }
 
-static void op_DESVNZ(cpu_t *self) // desvio condicional
+static void op_DESVNZ(cpu_t *self, int A1) // desvio condicional
 {
   if (self->A != 0) {
-    op_DESV(self);
+    op_DESV(self, A1);
   } else {
     self->PC += 2;
   }
 }
 
-static void op_DESVN(cpu_t *self) // desvio condicional
+static void op_DESVN(cpu_t *self, int A1) // desvio condicional
 {
   if (self->A < 0) {
-    op_DESV(self);
+    op_DESV(self, A1);
   } else {
     self->PC += 2;
   }
 }
 
-static void op_DESVP(cpu_t *self) // desvio condicional
+static void op_DESVP(cpu_t *self, int A1) // desvio condicional
 {
   if (self->A > 0) {
-    op_DESV(self);
+    op_DESV(self, A1);
   } else {
     self->PC += 2;
   }
 }
 
-static void op_CHAMA(cpu_t *self) // chamada de subrotina
+static void op_CHAMA(cpu_t *self, int A1) // chamada de subrotina
 {
-  int A1;
-  if (pega_A1(self, &A1) && poe_mem(self, A1, self->PC + 2)) {
+  if (poe_mem(self, A1, self->PC + 2)) {
     self->PC = A1 + 1;
   }
 }
 
-static void op_RET(cpu_t *self) // retorno de subrotina
+static void op_RET(cpu_t *self, int A1) // retorno de subrotina
 {
-  int A1, mA1;
-  if (pega_A1(self, &A1) && pega_mem(self, A1, &mA1)) {
+  int mA1;
+  if (pega_mem(self, A1, &mA1)) {
     self->PC = mA1;
   }
 }
 
-static void op_LE(cpu_t *self) // leitura de E/S
+static void op_LE(cpu_t *self, int A1) // leitura de E/S
 {
-  int A1, dado;
-  if (pega_A1(self, &A1) && pega_es(self, A1, &dado)) {
+  int dado;
+  if (pega_es(self, A1, &dado)) {
     self->A = dado;
     self->PC += 2;
   }
 }
 
-static void op_ESCR(cpu_t *self) // escrita de E/S
+static void op_ESCR(cpu_t *self, int A1) // escrita de E/S
 {
-  int A1;
-  if (pega_A1(self, &A1) && poe_es(self, A1, self->A)) {
+  if (poe_es(self, A1, self->A)) {
     self->PC += 2;
   }
 }
@@ -400,12 +413,12 @@ static void op_ESCR(cpu_t *self) // escrita de E/S
 // declara uma função auxiliar (só para a interrupção e o retorno ficarem perto)
 static void cpu_desinterrompe(cpu_t *self);
 
-static void op_RETI(cpu_t *self) // retorno de interrupção
+static void op_RETI(cpu_t *self, int A1) // retorno de interrupção
 {
   cpu_desinterrompe(self);
 }
 
-static void op_CHAMAC(cpu_t *self) // chama função em C
+static void op_CHAMAC(cpu_t *self, int A1) // chama função em C
 {
   if (self->funcaoC == NULL) {
     self->erro = ERR_OP_INV;
@@ -415,7 +428,7 @@ static void op_CHAMAC(cpu_t *self) // chama função em C
   self->PC += 1;
 }
 
-static void op_CHAMAS(cpu_t *self) // chamada de sistema
+static void op_CHAMAS(cpu_t *self, int A1) // chamada de sistema
 {
   self->PC += 1;
   // causa uma interrupção, para forçar a execução do SO
@@ -423,52 +436,126 @@ static void op_CHAMAS(cpu_t *self) // chamada de sistema
 
 }
 
-// EXECUTA UMA INSTRUÇÃO {{{1
+static void op_invalida(cpu_t *self, int A1) // opcode desconhecido
+{
+  self->erro = ERR_INSTR_INV;
+}
+
+// a função que implementa cada instrução
+// as pseudo-instruções não têm função, são instruções inválidas para a CPU
+static operacao_t operacoes[N_OPCODE] = {
+  [NOP]    = op_NOP,
+  [PARA]   = op_PARA,
+  [CARGI]  = op_CARGI,
+  [CARGM]  = op_CARGM,
+  [CARGX]  = op_CARGX,
+  [ARMM]   = op_ARMM,
+  [ARMX]   = op_ARMX,
+  [TRAX]   = op_TRAX,
+  [CPXA]   = op_CPXA,
+  [INCX]   = op_INCX,
+  [SOMA]   = op_SOMA,
+  [SUB]    = op_SUB,
+  [MULT]   = op_MULT,
+  [DIV]    = op_DIV,
+  [RESTO]  = op_RESTO,
+  [NEG]    = op_NEG,
+  [DESV]   = op_DESV,
+  [DESVZ]  = op_DESVZ,
+  [DESVNZ] = op_DESVNZ,
+  [DESVN]  = op_DESVN,
+  [DESVP]  = op_DESVP,
+  [CHAMA]  = op_CHAMA,
+  [RET]    = op_RET,
+  [LE]     = op_LE,
+  [ESCR]   = op_ESCR,
+  [RETI]   = op_RETI,
+  [CHAMAC] = op_CHAMAC,
+  [CHAMAS] = op_CHAMAS,
+};
+
+// BUSCA E DECODIFICAÇÃO {{{1
 
-static void executa_a_instrucao(cpu_t *self, int opcode)
-{
-  switch (opcode) {
-    case NOP:    op_NOP(self);    break;
-    case PARA:   op_PARA(self);   break;
-    case CARGI:  op_CARGI(self);  break;
-    case CARGM:  op_CARGM(self);  break;
-    case CARGX:  op_CARGX(self);  break;
-    case ARMM:   op_ARMM(self);   break;
-    case ARMX:   op_ARMX(self);   break;
-    case TRAX:   op_TRAX(self);   break;
-    case CPXA:   op_CPXA(self);   break;
-    case INCX:   op_INCX(self);   break;
-    case SOMA:   op_SOMA(self);   break;
-    case SUB:    op_SUB(self);    break;
-    case MULT:   op_MULT(self);   break;
-    case DIV:    op_DIV(self);    break;
-    case RESTO:  op_RESTO(self);  break;
-    case NEG:    op_NEG(self);    break;
-    case DESV:   op_DESV(self);   break;
-    case DESVZ:  op_DESVZ(self);  break;
-    case DESVNZ: op_DESVNZ(self); break;
-    case DESVN:  op_DESVN(self);  break;
-    case DESVP:  op_DESVP(self);  break;
-    case CHAMA:  op_CHAMA(self);  break;
-    case RET:    op_RET(self);    break;
-    case LE:     op_LE(self);     break;
-    case ESCR:   op_ESCR(self);   break;
-    case RETI:   op_RETI(self);   break;
-    case CHAMAC: op_CHAMAC(self); break;
-    case CHAMAS: op_CHAMAS(self); break;
-    default:     self->erro = ERR_INSTR_INV;
+// lê da memória a instrução no PC e decodifica em 'instr'
+// retorna false se não conseguiu ler, com o motivo em erro
+static bool decodifica(cpu_t *self, instr_decod_t *instr)
+{
+  int opcode;
+  if (!pega_mem(self, self->PC, &opcode)) return false;
+  instr->opcode = opcode;
+  instr->A1 = 0;
+  if (opcode < 0 || opcode >= N_OPCODE || operacoes[opcode] == NULL) {
+    instr->op = op_invalida;
+    instr->privilegiada = false;
+    return true;
   }
+  instr->op = operacoes[opcode];
+  instr->privilegiada = self->privilegiadas[opcode];
+  if (self->num_args[opcode] > 0) {
+    return pega_mem(self, self->PC + 1, &instr->A1);
+  }
+  return true;
 }
 
-void cpu_executa_1(cpu_t *self)
+// obtém a instrução no PC, decodificada
+// usa a versão guardada para o endereço físico do PC, se houver; senão
+//   decodifica e guarda (ou usa 'aux' se não puder guardar)
+// retorna NULL se ela não pode ser executada, com o motivo em erro
+static instr_decod_t *pega_instrucao(cpu_t *self, instr_decod_t *aux)
 {
-  // não executa se CPU já estiver em erro
-  if (self->erro != ERR_OK) return;
+  // não tem que testar endereços, é tarefa da mmu
+  int endfis;
+  self->erro = mmu_traduz(self->mmu, self->PC, &endfis, self->modo);
+  if (self->erro != ERR_OK) {
+    self->complemento = self->PC;
+    return NULL;
+  }
+  instr_decod_t *instr = &self->decod[endfis];
+  if (!instr->valida) {
+    // se o opcode está no último endereço do quadro, o argumento está em outra
+    //   página, cuja tradução pode mudar independente desta; não guarda
+    if (endfis % TAM_PAGINA == TAM_PAGINA - 1) instr = aux;
+    if (!decodifica(self, instr)) return NULL;
+    instr->valida = (instr != aux);
+  }
+  // não pode executar instrução privilegiada em modo usuário
+  if (self->modo == usuario && instr->privilegiada) {
+    self->erro = ERR_INSTR_PRIV;
+    return NULL;
+  }
+  return instr;
+}
 
-  int opcode;
-  if (pega_opcode(self, &opcode)) {
-    executa_a_instrucao(self, opcode);
+void cpu_memoria_alterada(void *cpu, int endereco)
+{
+  cpu_t *self = cpu;
+  // a instrução nesse endereço e a anterior (cujo argumento pode estar nesse
+  //   endereço) não valem mais
+  if (endereco >= 0 && endereco < self->tam_decod) {
+    self->decod[endereco].valida = false;
+  }
+  if (endereco > 0 && endereco <= self->tam_decod) {
+    self->decod[endereco - 1].valida = false;
   }
+}
+
+// EXECUTA UMA INSTRUÇÃO {{{1
+
+// executa a instrução no PC (a CPU não pode estar em erro)
+// retorna true se a execução pode continuar na instrução seguinte sem
+//   passar pelo controlador
+static bool executa_instrucao(cpu_t *self)
+{
+  bool continua = false;
+  self->instrucoes_executadas++;
+  instr_decod_t aux;
+  instr_decod_t *instr = pega_instrucao(self, &aux);
+  if (instr != NULL) {
+    instr->op(self, instr->A1);
+    continua = instr->opcode != CHAMAS && instr->opcode != CHAMAC;
+  }
+  // erro (inclusive PARA) também encerra a sequência
+  if (self->erro != ERR_OK) continua = false;
 
   // se a CPU entrou em erro, causa uma interrupção
   // a menos que a CPU tenha parado, porque a única forma de a CPU entrar nesse
@@ -479,6 +566,40 @@ void cpu_executa_1(cpu_t *self)
     // se a interrupção não é aceita nesse ponto, temos um problema grave...
     assert(cpu_interrompe(self, IRQ_ERR_CPU));
   }
+  return continua;
+}
+
+void cpu_executa_1(cpu_t *self)
+{
+  // não executa se CPU já estiver em erro
+  if (self->erro != ERR_OK) return;
+  executa_instrucao(self);
+}
+
+int cpu_executa_n(cpu_t *self, int n)
+{
+  int executadas = 0;
+  while (executadas < n && self->erro == ERR_OK) {
+    executadas++;
+    if (!executa_instrucao(self)) break;
+  }
+  return executadas;
+}
+
+bool cpu_parada(cpu_t *self)
+{
+  return self->erro == ERR_CPU_PARADA;
+}
+
+int cpu_instrucoes_executadas(cpu_t *self)
+{
+  return self->instrucoes_executadas;
+}
+
+bool cpu_entrando_no_tratador(cpu_t *self)
+{
+  return self->modo == supervisor && self->erro == ERR_OK
+         && self->PC == IRQ_END_TRATADOR;
 }
 
 // INTERRUPÇÃO {{{1
@@ -494,22 +615,23 @@ bool cpu_interrompe(cpu_t *self, irq_t irq)
   //   acesso (para quando existir proteção de memória)
   self->modo = supervisor;
 
-  // esta é uma CPU boazinha, salva todo o estado interno da CPU no início da memória
+  // esta é uma CPU boazinha, salva todo o estado interno da CPU na sua área
   // self->erro é alterado por poe_mem, copia antes!
   int erro = self->erro;
   int complemento = self->complemento;
-  poe_mem(self, IRQ_END_PC,          self->PC);
-  poe_mem(self, IRQ_END_A,           self->A);
-  poe_mem(self, IRQ_END_X,           self->X);
-  poe_mem(self, IRQ_END_erro,        erro);
-  poe_mem(self, IRQ_END_complemento, complemento);
-  poe_mem(self, IRQ_END_modo,        usuario);
+  int area = self->area_irq;
+  poe_mem(self, area + IRQ_END_PC,          self->PC);
+  poe_mem(self, area + IRQ_END_A,           self->A);
+  poe_mem(self, area + IRQ_END_X,           self->X);
+  poe_mem(self, area + IRQ_END_erro,        erro);
+  poe_mem(self, area + IRQ_END_complemento, complemento);
+  poe_mem(self, area + IRQ_END_modo,        usuario);
 
   // altera o estado da CPU para ela poder executar o tratador de interrupção
   // vai iniciar o tratamento da interrupção no endereço IRQ_END_TRATADOR,
   //   com o A contendo o valor da requisição de interrupção e sem erro
   // se o tratador da interrupção precisar do estado da CPU de antes da
-  //   interrupção, deve acessar o início da memória, onde esse estado foi salvo
+  //   interrupção, deve acessar a área onde esse estado foi salvo
   self->PC = IRQ_END_TRATADOR;
   self->A = irq;
   self->erro = ERR_OK;
@@ -525,14 +647,15 @@ static void cpu_desinterrompe(cpu_t *self)
   
   // tem que estar em modo supervisor para ler nesses endereços
   self->modo = supervisor;
-  pega_mem(self, IRQ_END_PC,          &self->PC);
-  pega_mem(self, IRQ_END_A,           &self->A);
-  pega_mem(self, IRQ_END_X,           &self->X);
+  int area = self->area_irq;
+  pega_mem(self, area + IRQ_END_PC,          &self->PC);
+  pega_mem(self, area + IRQ_END_A,           &self->A);
+  pega_mem(self, area + IRQ_END_X,           &self->X);
   // não dá para pegar o erro nem o modo diretamente porque eles não são int
   int erro, modo;
-  pega_mem(self, IRQ_END_erro,        &erro);
-  pega_mem(self, IRQ_END_complemento, &self->complemento);
-  pega_mem(self, IRQ_END_modo,        &modo);
+  pega_mem(self, area + IRQ_END_erro,        &erro);
+  pega_mem(self, area + IRQ_END_complemento, &self->complemento);
+  pega_mem(self, area + IRQ_END_modo,        &modo);
   self->modo = modo;
   // coloca o erro por último, porque pode ser alterado por pega_mem
   self->erro = erro;
@@ -22,19 +22,49 @@ typedef int (*func_chamaC_t)(void *argC, int reg_A);
 
 // cria uma unidade de execução com acesso à MMU e ao
 //   controlador de E/S fornecidos
-cpu_t *cpu_cria(mmu_t *mmu, es_t *es);
+// 'area_irq' é o endereço físico da área onde a CPU salva o seu estado
+//   quando aceita uma interrupção (IRQ_END_* são relativos a ele); cada CPU
+//   que compartilha a memória deve ter a sua
+cpu_t *cpu_cria(mmu_t *mmu, es_t *es, int area_irq);
 
 // destrói a unidade de execução
 void cpu_destroi(cpu_t *self);
 
+// retorna o endereço da área de salvamento do estado da CPU
+int cpu_area_irq(cpu_t *self);
+
+// informa à CPU que o conteúdo do endereço físico 'endereco' foi alterado,
+//   para que ela descarte as instruções decodificadas que dependem dele
+// segue o protocolo mem_f_alteracao_t declarado em memoria.h
+void cpu_memoria_alterada(void *cpu, int endereco);
+
 // executa a instrução apontada pelo PC
 //   se a CPU estiver em erro, não executa
 //   se a execução causar algum erro, altera o estado da CPU
 //     e causa uma interrupção
 void cpu_executa_1(cpu_t *self);
 
+// executa até 'n' instruções, como cpu_executa_1
+//   termina antes se a CPU causar uma interrupção (por CHAMAS ou erro),
+//   chamar o SO (CHAMAC) ou parar (PARA), porque depois disso o
+//   controlador pode ter que atender dispositivos
+// retorna o número de instruções executadas (0 se a CPU está parada)
+int cpu_executa_n(cpu_t *self, int n);
+
+// retorna true se a CPU está parada (executou PARA em modo supervisor) e
+//   só volta a executar quando aceitar uma interrupção
+bool cpu_parada(cpu_t *self);
+
+// retorna quantas instruções a CPU executou desde que foi criada, em modo
+//   usuário ou supervisor (inclusive as que causaram interrupção)
+int cpu_instrucoes_executadas(cpu_t *self);
+
+// retorna true se a CPU aceitou uma interrupção e ainda não chamou o SO (está
+//   no início do tratador de interrupção, em IRQ_END_TRATADOR)
+bool cpu_entrando_no_tratador(cpu_t *self);
+
 // implementa uma interrupção
-// passa para modo supervisor, salva o estado da CPU no início da memória,
+// passa para modo supervisor, salva o estado da CPU na sua área de salvamento,
 //   altera A para identificar a requisição de interrupção, altera PC para
 //   o endereço do tratador de interrupção
 // retorna true se interrupção foi aceita ou false caso contrário
@@ -0,0 +1,167 @@
+// ctrl_disco.c
+// dispositivo de E/S que controla o acesso ao disco
+// simulador de computador
+// so24b
+
+#include "ctrl_disco.h"
+#include "dispositivos.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+// tempos do disco, em tics
+// mover o braço custa um tempo fixo (acelerar e assentar) mais um tempo por
+//   trilha percorrida; cada setor leva TEMPO_POR_SETOR para passar sob a
+//   cabeça, e a transferência de um bloco é a passagem de um setor
+#define TEMPO_POSICIONAMENTO 8
+#define TEMPO_POR_TRILHA     1
+#define TEMPO_POR_SETOR      3
+#define TEMPO_VOLTA          (TEMPO_POR_SETOR * DISCO_SETORES_POR_TRILHA)
+
+struct ctrl_disco_t {
+  // tempo desde a criação, para saber a posição angular do disco
+  int agora;
+  // trilha onde está o braço
+  int trilha;
+  // primeiro bloco e número de blocos do próximo pedido, e o comando em
+  //   andamento (DISCO_NADA se livre)
+  int bloco;
+  int quantidade;
+  int comando;
+  // quanto tempo até terminar o pedido em andamento
+  int t_ate_fim;
+  // 1 se está gerando interrupção, 0 se não
+  int interrupcao;
+};
+
+ctrl_disco_t *ctrl_disco_cria(void)
+{
+  ctrl_disco_t *self;
+  self = malloc(sizeof(ctrl_disco_t));
+  assert(self != NULL);
+
+  self->agora = 0;
+  self->trilha = 0;
+  self->bloco = 0;
+  self->quantidade = 1;
+  self->comando = DISCO_NADA;
+  self->t_ate_fim = 0;
+  self->interrupcao = 0;
+
+  return self;
+}
+
+void ctrl_disco_destroi(ctrl_disco_t *self)
+{
+  free(self);
+}
+
+// calcula quanto tempo leva o acesso a 'quantidade' blocos a partir de
+//   'bloco', começando agora: busca da trilha, espera pelo primeiro setor
+//   (latência rotacional) e transferência; os blocos seguintes passam sob a
+//   cabeça em seguida (a troca de trilha no meio não é contada)
+static int ctrl_disco_tempo_de_acesso(ctrl_disco_t *self, int bloco,
+                                      int quantidade)
+{
+  int trilha = bloco / DISCO_SETORES_POR_TRILHA;
+  int setor = bloco % DISCO_SETORES_POR_TRILHA;
+
+  int distancia = abs(trilha - self->trilha);
+  int busca = 0;
+  if (distancia > 0) {
+    busca = TEMPO_POSICIONAMENTO + distancia * TEMPO_POR_TRILHA;
+  }
+
+  // onde o disco vai estar quando o braço chegar na trilha
+  int fase = (self->agora + busca) % TEMPO_VOLTA;
+  int espera = (setor * TEMPO_POR_SETOR - fase + TEMPO_VOLTA) % TEMPO_VOLTA;
+
+  return busca + espera + quantidade * TEMPO_POR_SETOR;
+}
+
+static err_t ctrl_disco_inicia(ctrl_disco_t *self, int comando)
+{
+  if (comando != DISCO_LE && comando != DISCO_ESCREVE) return ERR_OP_INV;
+  if (self->comando != DISCO_NADA) return ERR_OCUP;
+
+  self->t_ate_fim = ctrl_disco_tempo_de_acesso(self, self->bloco,
+                                               self->quantidade);
+  // o braço fica na trilha do último bloco (o tempo já foi contado)
+  self->trilha = (self->bloco + self->quantidade - 1) / DISCO_SETORES_POR_TRILHA;
+  self->comando = comando;
+  return ERR_OK;
+}
+
+void ctrl_disco_avanca(ctrl_disco_t *self, int tics)
+{
+  self->agora = (self->agora + tics) % TEMPO_VOLTA;
+  if (self->comando == DISCO_NADA) return;
+  if (tics >= self->t_ate_fim) {
+    self->t_ate_fim = 0;
+    self->comando = DISCO_NADA;
+    self->interrupcao = 1;
+  } else {
+    self->t_ate_fim -= tics;
+  }
+}
+
+int ctrl_disco_tics_ate_interrupcao(ctrl_disco_t *self)
+{
+  return self->t_ate_fim;
+}
+
+bool ctrl_disco_pede_interrupcao(ctrl_disco_t *self)
+{
+  return self->interrupcao != 0;
+}
+
+err_t ctrl_disco_leitura(void *disp, int id, int *pvalor)
+{
+  ctrl_disco_t *self = disp;
+  err_t err = ERR_OK;
+  switch (id) {
+    case 0:
+      *pvalor = self->bloco;
+      break;
+    case 1:
+      *pvalor = self->comando;
+      break;
+    case 2:
+      *pvalor = self->trilha;
+      break;
+    case 3:
+      *pvalor = self->interrupcao;
+      break;
+    case 4:
+      *pvalor = self->quantidade;
+      break;
+    default:
+      err = ERR_END_INV;
+  }
+  return err;
+}
+
+err_t ctrl_disco_escrita(void *disp, int id, int valor)
+{
+  ctrl_disco_t *self = disp;
+  err_t err = ERR_OK;
+  switch (id) {
+    case 0:
+      if (valor < 0) return ERR_OP_INV;
+      self->bloco = valor;
+      break;
+    case 1:
+      err = ctrl_disco_inicia(self, valor);
+      break;
+    case 3:
+      self->interrupcao = (valor == 0) ? 0 : 1;
+      break;
+    case 4:
+      if (valor < 1) return ERR_OP_INV;
+      self->quantidade = valor;
+      break;
+    default:
+      err = ERR_END_INV;
+  }
+  return err;
+}
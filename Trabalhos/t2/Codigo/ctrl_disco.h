@@ -0,0 +1,55 @@
+// ctrl_disco.h
+// dispositivo de E/S que controla o acesso ao disco
+// simulador de computador
+// so24b
+
+#ifndef CTRL_DISCO_H
+#define CTRL_DISCO_H
+
+// simulador da controladora de um disco de braço móvel
+// atende um pedido de cada vez: o SO diz a partir de qual bloco quer, quantos
+//   blocos consecutivos e se é leitura ou escrita, e a controladora fica
+//   ocupada pelo tempo que o disco levaria para posicionar o braço na trilha,
+//   esperar o primeiro setor passar sob a cabeça e transferir os blocos; no
+//   fim gera uma interrupção (IRQ_DISCO)
+// os dados não passam pela controladora (o conteúdo do disco fica em disco.h);
+//   ela simula só o tempo do acesso
+// a geometria do disco (setores por trilha) está em dispositivos.h
+
+#include "err.h"
+
+#include <stdbool.h>
+
+typedef struct ctrl_disco_t ctrl_disco_t;
+
+// cria uma controladora, com o braço na trilha 0
+ctrl_disco_t *ctrl_disco_cria(void);
+
+// destrói uma controladora
+void ctrl_disco_destroi(ctrl_disco_t *self);
+
+// registra a passagem de 'tics' unidades de tempo
+// o disco gira e, se tem pedido em andamento, ele avança
+void ctrl_disco_avanca(ctrl_disco_t *self, int tics);
+
+// retorna em quantas unidades de tempo o pedido em andamento termina,
+//   ou 0 se não tem pedido em andamento
+int ctrl_disco_tics_ate_interrupcao(ctrl_disco_t *self);
+
+// retorna true se a controladora está pedindo interrupção
+bool ctrl_disco_pede_interrupcao(ctrl_disco_t *self);
+
+// Funções para acessar a controladora como dispositivo de E/S, com id:
+//   '0' para ler ou escrever o primeiro bloco do próximo pedido
+//   '1' para escrever um comando (DISCO_LE ou DISCO_ESCREVE), que inicia um
+//       pedido para os blocos escritos em '0' e '4'; ler dá o comando em
+//       andamento, ou DISCO_NADA se a controladora está livre
+//   '2' para ler a trilha onde o braço está
+//   '3' para ler ou escrever se uma interrupção está sendo pedida
+//   '4' para ler ou escrever quantos blocos o próximo pedido transfere
+//       (começa em 1)
+// Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
+err_t ctrl_disco_leitura(void *disp, int id, int *pvalor);
+err_t ctrl_disco_escrita(void *disp, int id, int valor);
+
+#endif // CTRL_DISCO_H
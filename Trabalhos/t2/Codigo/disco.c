@@ -0,0 +1,139 @@
+// disco.c
+// memória secundária em um arquivo
+// simulador de computador
+// so24b
+
+#include "disco.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct disco_t {
+  int fd;
+  int tam_pagina;
+  int num_paginas;
+  // o arquivo mapeado
+  int *conteudo;
+};
+
+// mapeia as 'num_paginas' primeiras páginas do arquivo, aumentando o arquivo
+//   se ele for menor (a parte nova do arquivo fica zerada)
+static bool disco__mapeia(disco_t *self, int num_paginas)
+{
+  size_t tam = (size_t)num_paginas * self->tam_pagina * sizeof(int);
+  struct stat st;
+  if (fstat(self->fd, &st) != 0) return false;
+  if ((size_t)st.st_size < tam && ftruncate(self->fd, tam) != 0) return false;
+
+  void *p = mmap(NULL, tam, PROT_READ | PROT_WRITE, MAP_SHARED, self->fd, 0);
+  if (p == MAP_FAILED) return false;
+
+  self->conteudo = p;
+  self->num_paginas = num_paginas;
+  return true;
+}
+
+static void disco__desmapeia(disco_t *self)
+{
+  if (self->conteudo != NULL) {
+    munmap(self->conteudo,
+           (size_t)self->num_paginas * self->tam_pagina * sizeof(int));
+    self->conteudo = NULL;
+  }
+}
+
+disco_t *disco_cria(char *nome, int tam_pagina, int num_paginas)
+{
+  assert(tam_pagina > 0 && num_paginas > 0);
+
+  int fd = open(nome, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return NULL;
+
+  disco_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+  self->fd = fd;
+  self->tam_pagina = tam_pagina;
+  self->num_paginas = 0;
+  self->conteudo = NULL;
+
+  if (!disco__mapeia(self, num_paginas)) {
+    close(fd);
+    free(self);
+    return NULL;
+  }
+  return self;
+}
+
+void disco_destroi(disco_t *self)
+{
+  if (self != NULL) {
+    disco__desmapeia(self);
+    close(self->fd);
+    free(self);
+  }
+}
+
+int disco_num_paginas(disco_t *self)
+{
+  return self->num_paginas;
+}
+
+err_t disco_aumenta(disco_t *self, int num_paginas)
+{
+  if (num_paginas <= self->num_paginas) return ERR_OK;
+
+  // o arquivo pode ter conteúdo antigo além do tamanho atual; as páginas
+  //   novas são zeradas depois de mapeadas
+  int anterior = self->num_paginas;
+  disco__desmapeia(self);
+  if (!disco__mapeia(self, num_paginas)) {
+    // tenta voltar ao tamanho anterior
+    if (!disco__mapeia(self, anterior)) {
+      self->num_paginas = 0;
+    }
+    return ERR_END_INV;
+  }
+  memset(self->conteudo + (size_t)anterior * self->tam_pagina, 0,
+         (size_t)(num_paginas - anterior) * self->tam_pagina * sizeof(int));
+  return ERR_OK;
+}
+
+err_t disco_le_pagina(disco_t *self, int pagina, int *dados)
+{
+  if (pagina < 0 || pagina >= self->num_paginas) return ERR_END_INV;
+  memcpy(dados, self->conteudo + (size_t)pagina * self->tam_pagina,
+         self->tam_pagina * sizeof(int));
+  return ERR_OK;
+}
+
+err_t disco_escreve_pagina(disco_t *self, int pagina, int *dados)
+{
+  if (pagina < 0 || pagina >= self->num_paginas) return ERR_END_INV;
+  memcpy(self->conteudo + (size_t)pagina * self->tam_pagina, dados,
+         self->tam_pagina * sizeof(int));
+  return ERR_OK;
+}
+
+err_t disco_le(disco_t *self, int endereco, int *pvalor)
+{
+  if (endereco < 0 || endereco >= self->num_paginas * self->tam_pagina) {
+    return ERR_END_INV;
+  }
+  *pvalor = self->conteudo[endereco];
+  return ERR_OK;
+}
+
+err_t disco_escreve(disco_t *self, int endereco, int valor)
+{
+  if (endereco < 0 || endereco >= self->num_paginas * self->tam_pagina) {
+    return ERR_END_INV;
+  }
+  self->conteudo[endereco] = valor;
+  return ERR_OK;
+}
@@ -0,0 +1,50 @@
+// disco.h
+// memória secundária em um arquivo
+// simulador de computador
+// so24b
+
+#ifndef DISCO_H
+#define DISCO_H
+
+// o disco é dividido em páginas de tamanho fixo, e seu conteúdo fica em um
+//   arquivo do hospedeiro mapeado em memória (mmap), e não na memória do
+//   simulador: o disco pode ser maior que a memória do hospedeiro
+// o arquivo não é apagado no fim da simulação, mas o conteúdo não tem
+//   significado para a próxima: quem usa o disco (o SO) grava cada página
+//   antes de ler
+// cada valor ocupa um int no arquivo, na ordem de bytes do hospedeiro
+
+#include "err.h"
+
+// tipo opaco que representa o disco
+typedef struct disco_t disco_t;
+
+// cria um disco com 'num_paginas' páginas de 'tam_pagina' valores, no arquivo
+//   'nome' (criado se não existir; se for menor, é aumentado com zeros)
+// retorna NULL se não conseguir criar ou mapear o arquivo
+disco_t *disco_cria(char *nome, int tam_pagina, int num_paginas);
+
+// destrói o disco; o arquivo é mantido
+void disco_destroi(disco_t *self);
+
+// número de páginas do disco
+int disco_num_paginas(disco_t *self);
+
+// aumenta o disco para 'num_paginas' páginas (as novas são zeradas)
+// retorna ERR_OK ou ERR_END_INV se não conseguir
+err_t disco_aumenta(disco_t *self, int num_paginas);
+
+// copia a página 'pagina' do disco para 'dados' (com tam_pagina valores)
+// retorna ERR_END_INV se a página não existe
+err_t disco_le_pagina(disco_t *self, int pagina, int *dados);
+
+// copia 'dados' (com tam_pagina valores) para a página 'pagina' do disco
+// retorna ERR_END_INV se a página não existe
+err_t disco_escreve_pagina(disco_t *self, int pagina, int *dados);
+
+// acesso a um valor, pelo endereço em valores desde o início do disco
+// retornam ERR_END_INV se o endereço não existe
+err_t disco_le(disco_t *self, int endereco, int *pvalor);
+err_t disco_escreve(disco_t *self, int endereco, int valor);
+
+#endif // DISCO_H
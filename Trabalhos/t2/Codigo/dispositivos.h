@@ -27,6 +27,12 @@ typedef enum {
   D_RELOGIO_REAL          = 17,
   D_RELOGIO_TIMER         = 18,
   D_RELOGIO_INTERRUPCAO   = 19,
+  D_DISCO_BLOCO           = 20,
+  D_DISCO_COMANDO         = 21,
+  D_DISCO_TRILHA          = 22,
+  D_DISCO_INTERRUPCAO     = 23,
+  D_DISCO_QUANTIDADE      = 24,
+  D_IPI                   = 25,
   N_DISPOSITIVOS
 } dispositivo_id_t;
 
@@ -40,6 +46,17 @@ typedef enum {
 #define DEVICE_C 8
 #define DEVICE_D 12
 
+// comandos da controladora do disco (D_DISCO_COMANDO)
+#define DISCO_NADA 0
+#define DISCO_LE 1
+#define DISCO_ESCREVE 2
+
+// D_IPI: escrever o número de uma CPU faz ela receber IRQ_IPI (interrupção
+//   entre processadores)
+
+// geometria do disco: o bloco b está na trilha b / DISCO_SETORES_POR_TRILHA
+#define DISCO_SETORES_POR_TRILHA 8
+
 
 #endif // DISPOSITIVOS_H
 
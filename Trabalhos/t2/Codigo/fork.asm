@@ -0,0 +1,75 @@
+; fork.asm
+; programa de teste para SO
+; confere os valores de retorno de SO_FORK e a cópia na escrita
+;
+; o pai altera a variável 'var' e cria um filho com SO_FORK; o filho recebe 0
+;   em A, o pai recebe o pid do filho (maior que 0)
+; o filho confere que vê o valor que o pai colocou em 'var', altera 'var' e
+;   imprime 'F' e o novo valor; o pai espera o filho terminar, confere que
+;   'var' continua com o seu valor e imprime 'P' e esse valor
+; executar como processo inicial: ./main -b -i fork.maq
+; a saída esperada no terminal A é "FbPa"; um 'E' indica erro
+; os dados ficam no início do programa, na página que está na memória no
+;   momento do fork e que os dois processos passam a compartilhar
+
+; chamadas de sistema (ver so.h)
+SO_ESCR        define 2
+SO_MATA_PROC   define 8
+SO_ESPERA_PROC define 9
+SO_FORK        define 12
+
+         desv inicio
+var      valor 'x'
+
+inicio   cargi 'a'
+         armm var
+         cargi SO_FORK
+         chamas
+         desvz filho
+         desvn erro
+         ; pai: espera o filho terminar
+         trax
+         cargi SO_ESPERA_PROC
+         chamas
+         desvn erro
+         cargi 'P'
+         trax
+         cargi SO_ESCR
+         chamas
+         ; a alteração do filho não pode aparecer aqui
+         cargm var
+         sub a
+         desvnz erro
+         cargm var
+         trax
+         cargi SO_ESCR
+         chamas
+         desv fim
+
+         ; filho: vê o valor do pai, e altera só a sua cópia
+filho    cargm var
+         sub a
+         desvnz erro
+         cargi 'b'
+         armm var
+         cargi 'F'
+         trax
+         cargi SO_ESCR
+         chamas
+         cargm var
+         trax
+         cargi SO_ESCR
+         chamas
+         desv fim
+
+erro     cargi 'E'
+         trax
+         cargi SO_ESCR
+         chamas
+fim      cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+         para
+
+a        valor 'a'
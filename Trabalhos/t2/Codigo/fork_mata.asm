@@ -0,0 +1,52 @@
+; fork_mata.asm
+; programa de teste para SO
+; mata um processo que está executando em outra CPU
+;
+; cria um filho com SO_FORK; o filho fica em laço sem fazer chamadas de
+;   sistema, e o pai, depois de um tempo em laço (para o filho começar a
+;   executar), mata o filho, espera por ele e imprime 'K'
+; executar como processo inicial, com mais de uma CPU:
+;   ./main -b -c 2 -i fork_mata.maq
+; o filho está executando na outra CPU quando é morto; se a morte não for
+;   entregue a essa CPU, o filho não termina e a simulação não acaba
+
+; chamadas de sistema (ver so.h)
+SO_ESCR        define 2
+SO_MATA_PROC   define 8
+SO_ESPERA_PROC define 9
+SO_FORK        define 12
+
+         cargi SO_FORK
+         chamas
+         desvz filho
+         armm pidf
+         ; dá tempo para o filho ser escalonado na outra CPU
+         cargi 0
+         trax
+espera   incx
+         cpxa
+         sub voltas
+         desvnz espera
+         ; mata o filho e espera ele terminar
+         cargm pidf
+         trax
+         cargi SO_MATA_PROC
+         chamas
+         cargm pidf
+         trax
+         cargi SO_ESPERA_PROC
+         chamas
+         cargi 'K'
+         trax
+         cargi SO_ESCR
+         chamas
+         ; termina
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+         para
+filho    desv filho
+
+pidf     espaco 1
+voltas   valor 300
@@ -0,0 +1,89 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "frame_alloc.h"
+
+// free_stack[0..free_count-1] são os quadros livres, o topo no final
+// stack_pos[q] é a posição do quadro q na pilha, ou -1 se está ocupado
+// retirar um quadro do meio troca ele com o topo
+
+struct frame_alloc_t
+{
+    int num_frames;
+    int free_count;
+    int *free_stack;
+    int *stack_pos;
+};
+
+frame_alloc_t *frame_alloc_create(int num_frames)
+{
+    frame_alloc_t *fa = malloc(sizeof(frame_alloc_t));
+    assert(fa != NULL);
+
+    fa->num_frames = num_frames;
+    fa->free_stack = malloc(num_frames * sizeof(int));
+    fa->stack_pos = malloc(num_frames * sizeof(int));
+    assert(fa->free_stack != NULL && fa->stack_pos != NULL);
+
+    // empilhados do último para o primeiro, para o quadro 0 ficar no topo
+    fa->free_count = num_frames;
+    for (int i = 0; i < num_frames; i++)
+    {
+        int frame = num_frames - 1 - i;
+        fa->free_stack[i] = frame;
+        fa->stack_pos[frame] = i;
+    }
+
+    return fa;
+}
+
+void frame_alloc_destroy(frame_alloc_t *fa)
+{
+    free(fa->free_stack);
+    free(fa->stack_pos);
+    free(fa);
+}
+
+int frame_alloc_get(frame_alloc_t *fa)
+{
+    if (fa->free_count == 0) return -1;
+
+    int frame = fa->free_stack[--fa->free_count];
+    fa->stack_pos[frame] = -1;
+
+    return frame;
+}
+
+void frame_alloc_take(frame_alloc_t *fa, int frame)
+{
+    assert(frame >= 0 && frame < fa->num_frames);
+
+    int pos = fa->stack_pos[frame];
+    if (pos == -1) return;
+
+    int top = fa->free_stack[--fa->free_count];
+    fa->free_stack[pos] = top;
+    fa->stack_pos[top] = pos;
+    fa->stack_pos[frame] = -1;
+}
+
+void frame_alloc_put(frame_alloc_t *fa, int frame)
+{
+    assert(frame >= 0 && frame < fa->num_frames);
+    assert(fa->stack_pos[frame] == -1);
+
+    fa->free_stack[fa->free_count] = frame;
+    fa->stack_pos[frame] = fa->free_count;
+    fa->free_count++;
+}
+
+bool frame_alloc_is_free(frame_alloc_t *fa, int frame)
+{
+    return fa->stack_pos[frame] != -1;
+}
+
+int frame_alloc_free_count(frame_alloc_t *fa)
+{
+    return fa->free_count;
+}
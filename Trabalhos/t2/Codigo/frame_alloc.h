@@ -0,0 +1,33 @@
+#ifndef FRAME_ALLOC_H
+#define FRAME_ALLOC_H
+
+#include <stdbool.h>
+
+// alocador de quadros da memória física
+// os quadros livres ficam em uma pilha, e cada quadro sabe a sua posição nela,
+// então pegar um quadro livre, devolver um quadro e reservar um quadro
+// específico são O(1), sem percorrer a memória
+// quem está usando cada quadro continua no rastreador (mem_block_t)
+
+typedef struct frame_alloc_t frame_alloc_t;
+
+// cria o alocador com 'num_frames' quadros, todos livres
+frame_alloc_t *frame_alloc_create(int num_frames);
+void frame_alloc_destroy(frame_alloc_t *fa);
+
+// retira e retorna um quadro livre, ou -1 se não tiver
+// os quadros de número menor são entregues primeiro até que algum seja devolvido
+int frame_alloc_get(frame_alloc_t *fa);
+
+// retira dos livres o quadro 'frame'; não faz nada se ele já estiver ocupado
+void frame_alloc_take(frame_alloc_t *fa, int frame);
+
+// devolve o quadro 'frame', que não pode estar livre
+void frame_alloc_put(frame_alloc_t *fa, int frame);
+
+bool frame_alloc_is_free(frame_alloc_t *fa, int frame);
+
+// número de quadros livres
+int frame_alloc_free_count(frame_alloc_t *fa);
+
+#endif
@@ -12,6 +12,8 @@ static char *nomes[N_IRQ] = {
   [IRQ_RELOGIO] = "E/S: relógio",
   [IRQ_TECLADO] = "E/S: teclado",
   [IRQ_TELA]    = "E/S: console",
+  [IRQ_DISCO]   = "E/S: disco",
+  [IRQ_IPI]     = "Entre processadores",
 };
 
 // retorna o nome da interrupção
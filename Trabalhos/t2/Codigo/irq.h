@@ -14,23 +14,29 @@ typedef enum {
   IRQ_SISTEMA,       // chamada de sistema
   // interrupções geradas por dispositivos de E/S
   IRQ_RELOGIO,       // interrupção causada pelo relógio
-  // interrupções de E/S ainda não implementadas
-  IRQ_TECLADO,       // interrupção causada pelo teclado
-  IRQ_TELA,          // interrupção causada pela tela
+  IRQ_TECLADO,       // chegou entrada em algum terminal
+  IRQ_TELA,          // a saída de algum terminal voltou a aceitar caracteres
+  IRQ_DISCO,         // o disco terminou um pedido
+  // interrupção pedida por outra CPU (D_IPI)
+  IRQ_IPI,           // o SO, em outra CPU, quer que esta entre no SO
   N_IRQ              // número de interrupções
 } irq_t;
 
 char *irq_nome(irq_t irq);
 
-// endereços na memória onde a CPU salva os valores dos registradores
+// posições na memória onde a CPU salva os valores dos registradores
 //   quando aceita uma interrupção, e de onde recupera esses valores
 //   quando retorna de uma interrupção
+// as posições são relativas ao início da área de salvamento da CPU (ver
+//   cpu_cria); com uma CPU só, a área começa no endereço 0
 #define IRQ_END_PC          0
 #define IRQ_END_A           1
 #define IRQ_END_X           2
 #define IRQ_END_erro        3
 #define IRQ_END_complemento 4
 #define IRQ_END_modo        5
+// tamanho da área de salvamento
+#define IRQ_TAM_AREA        6
 
 // endereço para onde desviar quando aceita uma interrupção
 #define IRQ_END_TRATADOR   10
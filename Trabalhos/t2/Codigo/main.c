@@ -8,38 +8,82 @@
 #include "mmu.h"
 #include "cpu.h"
 #include "relogio.h"
+#include "ctrl_disco.h"
 #include "console.h"
 #include "terminal.h"
 #include "es.h"
 #include "dispositivos.h"
 #include "so.h"
+#include "rastro.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 
 // constantes
 #define MEM_TAM 100        // tamanho da memória principal
+#define MAX_CPUS 8         // número máximo de CPUs
 
 // estrutura com os componentes do computador simulado
 typedef struct {
   mem_t *mem;
-  mmu_t *mmu;
-  cpu_t *cpu;
+  // cada CPU tem a sua MMU (e a sua TLB); a memória é compartilhada
+  int n_cpus;
+  mmu_t *mmu[MAX_CPUS];
+  cpu_t *cpu[MAX_CPUS];
   relogio_t *relogio;
+  ctrl_disco_t *disco;
   console_t *console;
   es_t *es;
   controle_t *controle;
+  rastro_t *rastro;
 } hardware_t;
 
-static void cria_hardware(hardware_t *hw)
+// endereço da área onde a CPU 'i' salva o seu estado nas interrupções
+// a da primeira fica no início da memória, como sempre foi; as das outras
+//   ficam depois dos MEM_TAM endereços da memória principal
+static int area_irq_da_cpu(int i)
 {
-  // cria a memória e a MMU
-  hw->mem = mem_cria(MEM_TAM);
-  hw->mmu = mmu_cria(hw->mem);
+  if (i == 0) return 0;
+  return MEM_TAM + (i - 1) * IRQ_TAM_AREA;
+}
+
+// avisa todas as CPUs que a memória foi alterada (cada uma tem as suas
+//   instruções decodificadas)
+static void memoria_alterada(void *arg, int endereco)
+{
+  hardware_t *hw = arg;
+  for (int i = 0; i < hw->n_cpus; i++) {
+    cpu_memoria_alterada(hw->cpu[i], endereco);
+  }
+}
+
+static void cria_hardware(hardware_t *hw, int n_cpus, bool lote,
+                          bool paralelo, char *nome_rastro)
+{
+  // cria a memória e as MMUs
+  hw->n_cpus = n_cpus;
+  hw->mem = mem_cria(MEM_TAM + (n_cpus - 1) * IRQ_TAM_AREA);
+  for (int i = 0; i < n_cpus; i++) {
+    hw->mmu[i] = mmu_cria(hw->mem);
+  }
+  hw->rastro = NULL;
+  if (nome_rastro != NULL) {
+    hw->rastro = rastro_cria(nome_rastro);
+    if (hw->rastro == NULL) {
+      fprintf(stderr, "ERRO: não foi possível criar o rastro '%s'\n", nome_rastro);
+      exit(1);
+    }
+    for (int i = 0; i < n_cpus; i++) {
+      mmu_define_rastro(hw->mmu[i], hw->rastro);
+    }
+  }
 
   // cria dispositivos de E/S
-  hw->console = console_cria();
+  hw->console = console_cria(lote);
   hw->relogio = relogio_cria();
+  hw->disco = ctrl_disco_cria();
 
   // cria o controlador de E/S e registra os dispositivos
   //   por exemplo, o dispositivo 8 do controlador de E/S (e da CPU) será o
@@ -75,35 +119,112 @@ static void cria_hardware(hardware_t *hw)
   es_registra_dispositivo(hw->es, D_RELOGIO_REAL      , hw->relogio, 1, relogio_leitura, NULL);
   es_registra_dispositivo(hw->es, D_RELOGIO_TIMER     , hw->relogio, 2, relogio_leitura, relogio_escrita);
   es_registra_dispositivo(hw->es, D_RELOGIO_INTERRUPCAO,hw->relogio, 3, relogio_leitura, relogio_escrita);
+  // bloco e comando do pedido, trilha do braço, interrupção do disco, número
+  //   de blocos do pedido
+  es_registra_dispositivo(hw->es, D_DISCO_BLOCO       , hw->disco, 0, ctrl_disco_leitura, ctrl_disco_escrita);
+  es_registra_dispositivo(hw->es, D_DISCO_COMANDO     , hw->disco, 1, ctrl_disco_leitura, ctrl_disco_escrita);
+  es_registra_dispositivo(hw->es, D_DISCO_TRILHA      , hw->disco, 2, ctrl_disco_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_DISCO_INTERRUPCAO , hw->disco, 3, ctrl_disco_leitura, ctrl_disco_escrita);
+  es_registra_dispositivo(hw->es, D_DISCO_QUANTIDADE  , hw->disco, 4, ctrl_disco_leitura, ctrl_disco_escrita);
 
-  // cria a unidade de execução e inicializa com a MMU e E/S
-  hw->cpu = cpu_cria(hw->mmu, hw->es);
+  // cria as unidades de execução e inicializa com a MMU e E/S
+  for (int i = 0; i < n_cpus; i++) {
+    hw->cpu[i] = cpu_cria(hw->mmu[i], hw->es, area_irq_da_cpu(i));
+  }
+  // a CPU guarda instruções decodificadas, e precisa saber quando a memória
+  //   onde elas estão é alterada
+  if (n_cpus == 1) {
+    mem_define_f_alteracao(hw->mem, cpu_memoria_alterada, hw->cpu[0]);
+  } else {
+    mem_define_f_alteracao(hw->mem, memoria_alterada, hw);
+  }
 
-  // cria o controlador da CPU e inicializa com a unidade de execução, a console e
-  //   o relógio
-  hw->controle = controle_cria(hw->cpu, hw->console, hw->relogio);
+  // cria o controlador das CPUs e inicializa com as unidades de execução, a
+  //   console, o relógio e o disco
+  hw->controle = controle_cria(n_cpus, hw->cpu, hw->console, hw->relogio,
+                               hw->disco, lote, paralelo);
+  // interrupção entre processadores, pedida ao controlador
+  es_registra_dispositivo(hw->es, D_IPI, hw->controle, 0, NULL, controle_escrita_ipi);
 }
 
 static void destroi_hardware(hardware_t *hw)
 {
   controle_destroi(hw->controle);
-  cpu_destroi(hw->cpu);
+  for (int i = 0; i < hw->n_cpus; i++) {
+    cpu_destroi(hw->cpu[i]);
+  }
   es_destroi(hw->es);
   relogio_destroi(hw->relogio);
+  ctrl_disco_destroi(hw->disco);
   console_destroi(hw->console);
-  mmu_destroi(hw->mmu);
+  for (int i = 0; i < hw->n_cpus; i++) {
+    mmu_destroi(hw->mmu[i]);
+  }
+  if (hw->rastro != NULL) rastro_destroi(hw->rastro);
   mem_destroi(hw->mem);
 }
 
-int main()
+// opções de linha de comando:
+//   -b  modo lote: executa sem tela e sem operador, até o fim da simulação;
+//       a saída dos terminais vai para os arquivos saida_terminal_[abcd]
+//   -t arquivo  grava no arquivo o rastro dos acessos à memória virtual,
+//       para ser analisado pelo simpag
+//   -c n  simula um computador com 'n' CPUs (de 1 a MAX_CPUS, 1 se não for dado)
+//   -p  cada CPU executa na sua thread, em paralelo (a simulação deixa de ser
+//       determinística); só no modo lote, e sem rastro, que precisa de uma
+//       ordem única dos acessos
+//   -i programa  o processo inicial executa o programa (init.maq se não for
+//       dado), por exemplo um programa de teste
+static bool verifica_args(int argc, char *argv[argc], char **pnome_rastro,
+                          int *pn_cpus, bool *pparalelo,
+                          char **pprograma_inicial)
+{
+  bool lote = false;
+  *pnome_rastro = NULL;
+  *pparalelo = false;
+  *pn_cpus = 1;
+  *pprograma_inicial = "init.maq";
+  for (int argi = 1; argi < argc; argi++) {
+    if (strcmp(argv[argi], "-b") == 0) {
+      lote = true;
+    } else if (strcmp(argv[argi], "-t") == 0 && argi + 1 < argc) {
+      *pnome_rastro = argv[++argi];
+    } else if (strcmp(argv[argi], "-c") == 0 && argi + 1 < argc
+               && atoi(argv[argi + 1]) >= 1 && atoi(argv[argi + 1]) <= MAX_CPUS) {
+      *pn_cpus = atoi(argv[++argi]);
+    } else if (strcmp(argv[argi], "-p") == 0) {
+      *pparalelo = true;
+    } else if (strcmp(argv[argi], "-i") == 0 && argi + 1 < argc) {
+      *pprograma_inicial = argv[++argi];
+    } else {
+      fprintf(stderr, "ERRO: chame como '%s [-b] [-t rastro] [-c n [-p]] [-i programa]'\n", argv[0]);
+      exit(1);
+    }
+  }
+  if (*pparalelo && (!lote || *pnome_rastro != NULL)) {
+    fprintf(stderr, "ERRO: a opção -p só pode ser usada no modo lote (-b), sem -t\n");
+    exit(1);
+  }
+  return lote;
+}
+
+int main(int argc, char *argv[argc])
 {
   hardware_t hw;
   so_t *so;
 
+  char *nome_rastro;
+  int n_cpus;
+  bool paralelo;
+  char *programa_inicial;
+  bool lote = verifica_args(argc, argv, &nome_rastro, &n_cpus, &paralelo,
+                            &programa_inicial);
+
   // cria o hardware
-  cria_hardware(&hw);
+  cria_hardware(&hw, n_cpus, lote, paralelo, nome_rastro);
   // cria o sistema operacional
-  so = so_cria(hw.cpu, hw.mem, hw.mmu, hw.es, hw.console);
+  so = so_cria(hw.n_cpus, hw.cpu, hw.mmu, hw.mem, hw.es, hw.console,
+               programa_inicial);
   
   // executa o laço principal do controlador
   controle_laco(hw.controle);
@@ -16,6 +16,13 @@ mem_block_t *create_mem_blocks(int tamanho)
     mem_block_t *blocks = malloc(sizeof(mem_block_t) * tamanho);
     for (size_t i = 0; i < tamanho; i++)
     {
+        blocks[i].prev_owned = -1;
+        blocks[i].age = 0;
+        blocks[i].prefetched = false;
+        blocks[i].refs = 0;
+        blocks[i].slot = -1;
+        blocks[i].next_owned = -1;
+
         // dois primeiros blocos são espaço reservado
         if (i < 2)
         {
@@ -8,6 +8,21 @@ struct mem_block_t
   int page;
   int cicles;
   bool chance;
+  // idade para o algoritmo de envelhecimento (aging): a cada interrupção do
+  // relógio anda um bit para a direita, e o bit mais alto recebe o bit de acesso
+  unsigned char age;
+  // quadros do mesmo processo, encadeados pelo índice (-1 no fim da lista)
+  // a lista começa no processo (proc_get_frame_list)
+  int prev_owned;
+  int next_owned;
+  // a página foi trazida antes de ser pedida (junto com a vizinha que faltou),
+  // e ainda não se sabe se vai ser usada
+  bool prefetched;
+  // quantas tabelas de páginas mapeiam o quadro (mais de uma se está
+  // compartilhado), e o slot do disco com o mesmo conteúdo, se o quadro pode
+  // ser compartilhado (-1 se não)
+  int refs;
+  int slot;
 };
 
 typedef struct mem_block_t mem_block_t;
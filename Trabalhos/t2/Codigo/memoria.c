@@ -12,6 +12,9 @@
 struct mem_t {
   int tam;
   int *conteudo;
+  // função chamada a cada alteração, e seu argumento
+  mem_f_alteracao_t f_alteracao;
+  void *arg_alteracao;
 };
 
 mem_t *mem_cria(int tam)
@@ -24,6 +27,8 @@ mem_t *mem_cria(int tam)
   assert(self->conteudo != NULL);
 
   self->tam = tam;
+  self->f_alteracao = NULL;
+  self->arg_alteracao = NULL;
 
   return self;
 }
@@ -66,6 +71,15 @@ err_t mem_escreve(mem_t *self, int endereco, int valor)
   err_t err = verifica_permissao(self, endereco);
   if (err == ERR_OK) {
     self->conteudo[endereco] = valor;
+    if (self->f_alteracao != NULL) {
+      self->f_alteracao(self->arg_alteracao, endereco);
+    }
   }
   return err;
 }
+
+void mem_define_f_alteracao(mem_t *self, mem_f_alteracao_t f, void *arg)
+{
+  self->f_alteracao = f;
+  self->arg_alteracao = arg;
+}
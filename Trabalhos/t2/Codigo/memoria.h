@@ -11,6 +11,10 @@
 // tipo opaco que representa a memória
 typedef struct mem_t mem_t;
 
+// tipo da função chamada quando o conteúdo de um endereço da memória é alterado
+// recebe o argumento fornecido no registro da função e o endereço alterado
+typedef void (*mem_f_alteracao_t)(void *arg, int endereco);
+
 // cria uma região de memória com capacidade para 'tam' valores (inteiros)
 // retorna um ponteiro para um descritor, que deverá ser usado em todas
 //   as operações sobre essa memória
@@ -29,6 +33,14 @@ err_t mem_le(mem_t *self, int endereco, int *pvalor);
 
 // coloca 'valor' no endereço 'endereco' da memória
 // retorna erro ERR_END_INV se endereço inválido
+// se tiver uma função de alteração registrada, chama essa função
 err_t mem_escreve(mem_t *self, int endereco, int valor);
 
+// registra a função a ser chamada (com o argumento 'arg') a cada escrita
+//   bem sucedida na memória
+// serve para quem guarda informação derivada do conteúdo da memória (como a CPU,
+//   com instruções decodificadas) saber quando ela deixa de valer
+// se 'f' for NULL, não chama nada
+void mem_define_f_alteracao(mem_t *self, mem_f_alteracao_t f, void *arg);
+
 #endif // MEMORIA_H
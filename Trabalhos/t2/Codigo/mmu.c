@@ -8,12 +8,39 @@
 #include <stdlib.h>
 #include <assert.h>
 
+// número de entradas na TLB
+#define TLB_TAM 16
+
+// uma entrada da TLB: a tradução de uma página de um espaço de endereçamento,
+//   se ela pode ser escrita, e os bits de acesso e alteração que ainda não
+//   foram marcados na tabela de páginas
+typedef struct {
+  bool valida;
+  int asid;
+  int pagina;
+  int quadro;
+  bool protegida;
+  bool acessada;
+  bool alterada;
+  // tabela de onde a tradução veio, para onde os bits vão ser devolvidos
+  tabpag_t *tabpag;
+} tlb_entrada_t;
+
 // tipo de dados opaco para representar uma MMU
 struct mmu_t {
   // memória física
   mem_t *mem;
   // tabela de páginas
   tabpag_t *tabpag;
+  // identificador do espaço de endereçamento da tabela de páginas
+  int asid;
+  // TLB, com mapeamento direto; as entradas são identificadas pelo asid,
+  //   e não precisam ser descartadas quando a tabela de páginas muda
+  tlb_entrada_t tlb[TLB_TAM];
+  long tlb_acertos;
+  long tlb_falhas;
+  // onde registrar os acessos, NULL se não registra
+  rastro_t *rastro;
 };
 
 mmu_t *mmu_cria(mem_t *mem)
@@ -23,6 +50,13 @@ mmu_t *mmu_cria(mem_t *mem)
   assert(self != NULL);
   self->mem = mem;
   self->tabpag = NULL;
+  self->asid = 0;
+  for (int i = 0; i < TLB_TAM; i++) {
+    self->tlb[i].valida = false;
+  }
+  self->tlb_acertos = 0;
+  self->tlb_falhas = 0;
+  self->rastro = NULL;
   return self;
 }
 
@@ -34,27 +68,104 @@ void mmu_destroi(mmu_t *self)
   }
 }
 
+int mmu_tam_mem(mmu_t *self)
+{
+  return mem_tam(self->mem);
+}
+
+// TLB {{{1
+
+// retorna a entrada da TLB onde pode estar a página 'pagina' do espaço 'asid'
+static tlb_entrada_t *mmu__entrada_tlb(mmu_t *self, int asid, int pagina)
+{
+  unsigned indice = (unsigned)pagina + (unsigned)asid * 5;
+  return &self->tlb[indice % TLB_TAM];
+}
+
+// passa para a tabela de páginas os bits que estão marcados só na entrada
+static void mmu__devolve_bits(tlb_entrada_t *entrada)
+{
+  if (entrada->acessada) {
+    tabpag_marca_bit_acesso(entrada->tabpag, entrada->pagina, entrada->alterada);
+  }
+  entrada->acessada = false;
+  entrada->alterada = false;
+}
+
+// sincroniza a TLB com a tabela de páginas 'tabpag', que vai consultar ou
+//   alterar a página 'pagina' (ou todas, se -1)
+// segue o protocolo tabpag_f_sincroniza_t
+static void mmu__sincroniza(void *arg, tabpag_t *tabpag, int pagina, bool esquece)
+{
+  mmu_t *self = arg;
+  for (int i = 0; i < TLB_TAM; i++) {
+    tlb_entrada_t *entrada = &self->tlb[i];
+    if (!entrada->valida || entrada->tabpag != tabpag) continue;
+    if (pagina != -1 && entrada->pagina != pagina) continue;
+    mmu__devolve_bits(entrada);
+    if (esquece) entrada->valida = false;
+  }
+}
+
 void mmu_define_tabpag(mmu_t *self, tabpag_t *tabpag)
 {
   self->tabpag = tabpag;
+  if (tabpag != NULL) {
+    self->asid = tabpag_asid(tabpag);
+    // a tabela deve avisar a MMU antes de mexer em páginas que podem estar na TLB
+    tabpag_define_f_sincroniza(tabpag, mmu__sincroniza, self);
+  }
+}
+
+void mmu_estatisticas_tlb(mmu_t *self, long *pacertos, long *pfalhas)
+{
+  *pacertos = self->tlb_acertos;
+  *pfalhas = self->tlb_falhas;
+}
+
+void mmu_define_rastro(mmu_t *self, rastro_t *rastro)
+{
+  self->rastro = rastro;
 }
 
-// tradur o endereço virtual 'endvirt', colocando o endereço físico
-//   correspondente em 'pendfis'.
+// TRADUÇÃO {{{1
+
+// traduz o endereço virtual 'endvirt', colocando o endereço físico
+//   correspondente em 'pendfis' e a entrada da TLB usada em 'pentrada'.
+// se a tradução não está na TLB, busca na tabela de páginas e coloca na TLB,
+//   devolvendo para a tabela os bits da entrada substituída
 // retorna ERR_OK ou um erro se a tradução não for possível
-static err_t mmu__traduz(mmu_t *self, int endvirt, int *pendfis)
+static err_t mmu__traduz(mmu_t *self, int endvirt, int *pendfis,
+                         tlb_entrada_t **pentrada)
 {
   int pagina = endvirt / TAM_PAGINA;
   int deslocamento = endvirt % TAM_PAGINA;
-  int quadro;
-  err_t err = tabpag_traduz(self->tabpag, pagina, &quadro);
-  if (err == ERR_OK) {
-    *pendfis = quadro * TAM_PAGINA + deslocamento;
+  tlb_entrada_t *entrada = mmu__entrada_tlb(self, self->asid, pagina);
+  if (entrada->valida && entrada->asid == self->asid && entrada->pagina == pagina) {
+    self->tlb_acertos++;
+  } else {
+    self->tlb_falhas++;
+    int quadro;
+    err_t err = tabpag_traduz(self->tabpag, pagina, &quadro);
+    if (err != ERR_OK) return err;
+    if (entrada->valida) mmu__devolve_bits(entrada);
+    entrada->valida = true;
+    entrada->asid = self->asid;
+    entrada->pagina = pagina;
+    entrada->quadro = quadro;
+    entrada->protegida = tabpag_pagina_protegida(self->tabpag, pagina);
+    entrada->acessada = false;
+    entrada->alterada = false;
+    entrada->tabpag = self->tabpag;
   }
+  *pendfis = entrada->quadro * TAM_PAGINA + deslocamento;
+  *pentrada = entrada;
 
-  return err;
+  return ERR_OK;
 }
 
+// ACESSO {{{1
+
 err_t mmu_le(mmu_t *self, int endvirt, int *pvalor, cpu_modo_t modo)
 {
   // em modo supervisor ou se não tiver tabela de páginas,
@@ -63,16 +174,40 @@ err_t mmu_le(mmu_t *self, int endvirt, int *pvalor, cpu_modo_t modo)
     return mem_le(self->mem, endvirt, pvalor);
   }
   int endfis;
-  err_t err = mmu__traduz(self, endvirt, &endfis);
+  tlb_entrada_t *entrada;
+  err_t err = mmu__traduz(self, endvirt, &endfis, &entrada);
   if (err == ERR_OK) {
     err = mem_le(self->mem, endfis, pvalor);
     if (err == ERR_OK) {
-      tabpag_marca_bit_acesso(self->tabpag, endvirt / TAM_PAGINA, false);
+      entrada->acessada = true;
+      if (self->rastro != NULL) {
+        rastro_registra(self->rastro, self->asid, entrada->pagina, false);
+      }
     }
   }
   return err;
 }
 
+err_t mmu_traduz(mmu_t *self, int endvirt, int *pendfis, cpu_modo_t modo)
+{
+  if (modo == supervisor || self->tabpag == NULL) {
+    if (endvirt < 0 || endvirt >= mem_tam(self->mem)) return ERR_END_INV;
+    *pendfis = endvirt;
+    return ERR_OK;
+  }
+  int endfis;
+  tlb_entrada_t *entrada;
+  err_t err = mmu__traduz(self, endvirt, &endfis, &entrada);
+  if (err != ERR_OK) return err;
+  if (endfis < 0 || endfis >= mem_tam(self->mem)) return ERR_END_INV;
+  entrada->acessada = true;
+  if (self->rastro != NULL) {
+    rastro_registra(self->rastro, self->asid, entrada->pagina, false);
+  }
+  *pendfis = endfis;
+  return ERR_OK;
+}
+
 err_t mmu_escreve(mmu_t *self, int endvirt, int valor, cpu_modo_t modo)
 {
   // em modo supervisor ou se não tiver tabela de páginas,
@@ -81,12 +216,21 @@ err_t mmu_escreve(mmu_t *self, int endvirt, int valor, cpu_modo_t modo)
     return mem_escreve(self->mem, endvirt, valor);
   }
   int endfis;
-  err_t err = mmu__traduz(self, endvirt, &endfis);
+  tlb_entrada_t *entrada;
+  err_t err = mmu__traduz(self, endvirt, &endfis, &entrada);
+  // escrita em página protegida: não altera a memória, o SO decide o que fazer
+  if (err == ERR_OK && entrada->protegida) err = ERR_PAG_PROTEGIDA;
   if (err == ERR_OK) {
     err = mem_escreve(self->mem, endfis, valor);
     if (err == ERR_OK) {
-      tabpag_marca_bit_acesso(self->tabpag, endvirt / TAM_PAGINA, true);
+      entrada->acessada = true;
+      entrada->alterada = true;
+      if (self->rastro != NULL) {
+        rastro_registra(self->rastro, self->asid, entrada->pagina, true);
+      }
     }
   }
   return err;
 }
+
+// vim: foldmethod=marker
@@ -10,11 +10,16 @@
 // realiza a tradução de endereços virtuais do espaço de endereçamento
 //   de um processo em endereços físicos da memória principal
 // implementa memória virtual por paginação
+// mantém uma TLB com as traduções usadas recentemente, identificadas pelo
+//   espaço de endereçamento (ver tabpag_asid); os bits de acesso e alteração
+//   são marcados na TLB, e só passados à tabela de páginas quando a entrada é
+//   substituída ou quando a tabela os consulta
 
 // tipo opaco que representa a MMU
 typedef struct mmu_t mmu_t;
 
 #include "tabpag.h"
+#include "rastro.h"
 #include "memoria.h"
 #include "err.h"
 #include "cpu.h"
@@ -34,10 +39,23 @@ mmu_t *mmu_cria(mem_t *mem);
 // nenhuma outra operação pode ser realizada na MMU após esta chamada
 void mmu_destroi(mmu_t *self);
 
+// retorna o tamanho da memória física gerenciada pela MMU
+int mmu_tam_mem(mmu_t *self);
+
 // define a tabela de páginas a usar nas próximas traduções
 // se tabpag for NULL, os acessos serão repassados sem alteração à memória
+// as traduções de outras tabelas que estão na TLB não são descartadas
 void mmu_define_tabpag(mmu_t *self, tabpag_t *tabpag);
 
+// coloca em '*pacertos' o número de traduções encontradas na TLB e em
+//   '*pfalhas' o número das que precisaram consultar a tabela de páginas
+void mmu_estatisticas_tlb(mmu_t *self, long *pacertos, long *pfalhas);
+
+// define o rastro onde registrar os acessos traduzidos com sucesso (página
+//   virtual e espaço de endereçamento, ver rastro.h); NULL para não registrar
+// o rastro não pertence à MMU
+void mmu_define_rastro(mmu_t *self, rastro_t *rastro);
+
 // coloca na posição apontada por 'pvalor' o valor que está na memória
 //   no endereço físico correspondente ao endereço virtual 'endvirt'
 // marca a página como acessada se o acesso for bem sucedido
@@ -48,11 +66,20 @@ void mmu_define_tabpag(mmu_t *self, tabpag_t *tabpag);
 //   à memória sem tradução
 err_t mmu_le(mmu_t *self, int endvirt, int *pvalor, cpu_modo_t modo);
 
+// coloca na posição apontada por 'pendfis' o endereço físico correspondente
+//   ao endereço virtual 'endvirt', sem acessar a memória
+// marca a página como acessada (como em uma leitura) se a tradução for possível
+// retorna erro se a tradução não for possível (ver tabpag_traduz) ou se o
+//   endereço físico não existir na memória (ERR_END_INV)
+// em modo supervisor ou sem tabela de páginas definida, não há tradução
+err_t mmu_traduz(mmu_t *self, int endvirt, int *pendfis, cpu_modo_t modo);
+
 // coloca 'valor' no endereço físico da memória correspondente ao endereço
 //   virtual 'endvirt'
 // marca a página como acessada e alterada se o acesso for bem sucedido
 // retorna erro se acesso não for possível, por um erro de tradução
-//   (ver tabpag_traduz) ou de memória (ver mem_escreve)
+//   (ver tabpag_traduz), de memória (ver mem_escreve) ou se a página está
+//   protegida contra escrita (ERR_PAG_PROTEGIDA, ver tabpag_protege_pagina)
 // se o acesso for feito em modo supervisor, ou se a mmu não tiver tabela de
 //   página definida, trata 'endvirt' como endereço físico, repassa o acesso
 //   à memória sem tradução
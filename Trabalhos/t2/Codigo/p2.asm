@@ -15,6 +15,7 @@ SO_ESCR        define 2
 SO_CRIA_PROC   define 7
 SO_MATA_PROC   define 8
 SO_ESPERA_PROC define 9
+SO_ESCR_BLOCO  define 10
 
 main
          chama impr_inicio
@@ -66,14 +67,23 @@ ene      valor N
 
 ; imprime a string que inicia em A (destroi X)
 impstr   espaco 1
+         armm is_desc
          trax
 impstr1
          cargx 0
          desvz impstrf
-         chama impch
          incx
          desv impstr1
-impstrf  ret impstr
+impstrf  cpxa
+         sub is_desc
+         armm is_tam
+         cargi is_desc
+         trax
+         cargi SO_ESCR_BLOCO
+         chamas
+         ret impstr
+is_desc  espaco 1 ; descritor da string para o SO: endereço e tamanho
+is_tam   espaco 1
 
 ; função que chama o SO para imprimir o caractere em A
 ; retorna em A o código de erro do SO
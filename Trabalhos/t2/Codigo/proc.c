@@ -30,9 +30,49 @@ struct process_t
 
     proc_metrics_t metrics;
 
+    rq_node_t rq_node;
+
+    proc_io_t io;
+
     tabpag_t* page_table;
 
-    int disk_address;
+    // slot da memória secundária de cada página
+    int *swap_slots;
+    int num_pages;
+
+    // primeiro quadro da lista de quadros do processo (mem_block_t), -1 se vazia
+    int frame_list;
+
+    // quantas páginas seguintes a que faltou são trazidas junto na falta
+    int prefetch_window;
+
+    // nível do processo no escalonador MLFQ (0 é o mais prioritário)
+    int sched_level;
+
+    // CPU dona da fila de prontos onde o processo é colocado
+    int cpu;
+
+    // escalonador justo: tempo virtual de execução, nice e posição na fila
+    long vruntime;
+    int nice;
+    vr_node_t vr_node;
+};
+
+// peso de cada nice, de PROC_NICE_MIN a PROC_NICE_MAX (os mesmos do Linux):
+// o peso do nice 0 é 1024, e cada nível a mais tem cerca de 1/1.25 do peso do
+// anterior, então um nível de diferença dá uns 10% a mais ou a menos de CPU
+#define PROC_PESO_NICE_0 1024
+
+static const int proc_peso_do_nice[PROC_NICE_MAX - PROC_NICE_MIN + 1] =
+{
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15,
 };
 
 
@@ -62,10 +102,31 @@ process_t *proc_create(int id)
     process->metrics.executing_time = 0;
 
     process->metrics.page_faults = 0;
+    process->metrics.resident_pages = 0;
+    process->metrics.max_resident_pages = 0;
 
     /* -------- metrics end here -------- */
 
+    process->rq_node.prev = NULL;
+    process->rq_node.next = NULL;
+    process->rq_node.level = 0;
+    process->rq_node.queued = false;
+
+    process->io.tam = 0;
+    process->io.pos = 0;
+    process->io.end_destino = 0;
+
     process->page_table = tabpag_cria();
+    process->frame_list = -1;
+    process->swap_slots = NULL;
+    process->num_pages = 0;
+    process->prefetch_window = 0;
+    process->sched_level = 0;
+    process->cpu = 0;
+    process->vruntime = 0;
+    process->nice = 0;
+    process->vr_node.index = -1;
+    process->vr_node.seq = 0;
 
     return process;
 }
@@ -130,14 +191,65 @@ proc_metrics_t *proc_get_metrics_ptr(process_t *proc)
     return &proc->metrics;
 }
 
+rq_node_t *proc_get_rq_node_ptr(process_t *proc)
+{
+    return &proc->rq_node;
+}
+
+vr_node_t *proc_get_vr_node_ptr(process_t *proc)
+{
+    return &proc->vr_node;
+}
+
+proc_io_t *proc_get_io_ptr(process_t *proc)
+{
+    return &proc->io;
+}
+
 tabpag_t *proc_get_tab_pag(process_t* proc)
 {
     return proc->page_table;
 }
 
-int proc_get_disk_address(process_t *proc)
+int proc_get_swap_slot(process_t *proc, int pagina)
+{
+    if (pagina < 0 || pagina >= proc->num_pages) return -1;
+    return proc->swap_slots[pagina];
+}
+
+int proc_get_num_pages(process_t *proc)
+{
+    return proc->num_pages;
+}
+
+int proc_get_frame_list(process_t *proc)
+{
+    return proc->frame_list;
+}
+
+int proc_get_prefetch_window(process_t *proc)
+{
+    return proc->prefetch_window;
+}
+
+int proc_get_sched_level(process_t *proc)
+{
+    return proc->sched_level;
+}
+
+int proc_get_cpu(process_t *proc)
+{
+    return proc->cpu;
+}
+
+long proc_get_vruntime(process_t *proc)
 {
-    return proc->disk_address;
+    return proc->vruntime;
+}
+
+int proc_get_nice(process_t *proc)
+{
+    return proc->nice;
 }
 
 /*---------------------------------------------------------------*/
@@ -212,9 +324,63 @@ void proc_set_block_info(process_t *proc, int block_info)
     proc->block_info = block_info;
 }
 
-void proc_set_disk_address(process_t *proc, int disk_address)
+void proc_set_swap_slot(process_t *proc, int pagina, int slot)
+{
+    if (pagina >= proc->num_pages)
+    {
+        proc->swap_slots = realloc(proc->swap_slots, (pagina + 1) * sizeof(int));
+        for (int i = proc->num_pages; i <= pagina; i++)
+        {
+            proc->swap_slots[i] = -1;
+        }
+        proc->num_pages = pagina + 1;
+    }
+
+    proc->swap_slots[pagina] = slot;
+}
+
+void proc_clear_swap_slots(process_t *proc)
+{
+    free(proc->swap_slots);
+    proc->swap_slots = NULL;
+    proc->num_pages = 0;
+}
+
+void proc_set_frame_list(process_t *proc, int frame)
+{
+    proc->frame_list = frame;
+}
+
+void proc_set_prefetch_window(process_t *proc, int window)
+{
+    proc->prefetch_window = window;
+}
+
+void proc_set_sched_level(process_t *proc, int level)
 {
-    proc->disk_address = disk_address;
+    proc->sched_level = level;
+}
+
+void proc_set_cpu(process_t *proc, int cpu)
+{
+    proc->cpu = cpu;
+}
+
+void proc_set_vruntime(process_t *proc, long vruntime)
+{
+    proc->vruntime = vruntime;
+}
+
+void proc_set_nice(process_t *proc, int nice)
+{
+    if (nice < PROC_NICE_MIN) nice = PROC_NICE_MIN;
+    if (nice > PROC_NICE_MAX) nice = PROC_NICE_MAX;
+    proc->nice = nice;
+}
+
+void proc_set_tab_pag(process_t *proc, tabpag_t *tab_pag)
+{
+    proc->page_table = tab_pag;
 }
 
 void proc_set_priority(process_t *proc, int priority)
@@ -232,6 +398,19 @@ void proc_increment_preemption(process_t *proc)
     proc->metrics.preemptions++;
 }
 
+void proc_charge_vruntime(process_t *proc, int elapsed)
+{
+    int peso = proc_peso_do_nice[proc->nice - PROC_NICE_MIN];
+    proc->vruntime += (long)elapsed * PROC_PESO_NICE_0 / peso;
+}
+
+int proc_instrucoes_ate_vruntime(process_t *proc, long vruntime)
+{
+    if (proc->vruntime > vruntime) return 0;
+    int peso = proc_peso_do_nice[proc->nice - PROC_NICE_MIN];
+    return (vruntime - proc->vruntime) * peso / PROC_PESO_NICE_0 + 1;
+}
+
 void proc_calc_existence_time(process_t *proc)
 {
     proc->metrics.existence_time = (proc->metrics.ready_time + proc->metrics.blocked_time + proc->metrics.executing_time);   
@@ -1,6 +1,10 @@
 #ifndef PROC_H
 #define PROC_H
 
+#include <stdbool.h>
+
+#include "tabpag.h"
+
 typedef struct process_t process_t;
 typedef int exec_state_t;
 typedef struct proc_metrics_t proc_metrics_t;
@@ -21,8 +25,55 @@ struct proc_metrics_t
     double avg_response_time;
 
     int page_faults;
+
+    // quadros da memória principal ocupados pelo processo
+    int resident_pages;
+    int max_resident_pages;
 };
 
+// buffer do SO para as chamadas de E/S em bloco (SO_LE_BLOCO e SO_ESCR_BLOCO)
+// enquanto tam > 0 o processo tem uma E/S em bloco em andamento:
+// - na escrita, buf tem os caracteres a escrever, e pos é o próximo
+// - na leitura, tam é o máximo a ler e end_destino onde colocar no processo
+#define PROC_TAM_BUF_ES 100
+
+typedef struct proc_io_t proc_io_t;
+
+struct proc_io_t
+{
+    int buf[PROC_TAM_BUF_ES];
+    int tam;
+    int pos;
+    int end_destino;
+};
+
+// encadeamento do processo na fila de prontos ou de espera (ver runqueue.h)
+typedef struct rq_node_t rq_node_t;
+
+struct rq_node_t
+{
+    process_t *prev;
+    process_t *next;
+    int level;
+    bool queued;
+};
+
+// posição do processo na fila ordenada por tempo virtual (ver vrqueue.h)
+typedef struct vr_node_t vr_node_t;
+
+struct vr_node_t
+{
+    // posição no heap, -1 se não está na fila
+    int index;
+    // ordem de chegada na fila, para desempate
+    long seq;
+};
+
+// prioridade estática do escalonador justo (nice): quanto menor, maior o peso
+// do processo, e mais devagar o seu tempo virtual anda
+#define PROC_NICE_MIN -20
+#define PROC_NICE_MAX 19
+
 
 #define PROC_EXECUTANDO 0
 #define PROC_PRONTO 1
@@ -49,10 +100,25 @@ int proc_get_block_type(process_t *proc);
 int proc_get_block_info(process_t *proc);
 double proc_get_priority(process_t *proc);
 proc_metrics_t *proc_get_metrics_ptr(process_t *proc);
+rq_node_t *proc_get_rq_node_ptr(process_t *proc);
+vr_node_t *proc_get_vr_node_ptr(process_t *proc);
+proc_io_t *proc_get_io_ptr(process_t *proc);
 int proc_get_complemento(process_t *proc);
 int proc_get_erro(process_t* proc);
 tabpag_t *proc_get_tab_pag(process_t* proc);
-int proc_get_disk_address(process_t *proc);
+// slot da memória secundária (swap.h) com a página 'pagina', -1 se não tem
+int proc_get_swap_slot(process_t *proc, int pagina);
+int proc_get_num_pages(process_t *proc);
+int proc_get_frame_list(process_t *proc);
+// quantas páginas seguintes a que faltou são trazidas junto na falta de página
+int proc_get_prefetch_window(process_t *proc);
+// nível do processo no escalonador MLFQ, mantido também enquanto bloqueado
+int proc_get_sched_level(process_t *proc);
+// CPU em cuja fila de prontos o processo fica (onde executou por último)
+int proc_get_cpu(process_t *proc);
+// tempo virtual de execução e nice, do escalonador justo
+long proc_get_vruntime(process_t *proc);
+int proc_get_nice(process_t *proc);
 
 
 void proc_set_ID(process_t *proc, int id);
@@ -66,11 +132,28 @@ void proc_set_block_info(process_t *proc, int block_info);
 void proc_set_priority(process_t *proc, int priority);
 void proc_set_complemento(process_t *proc, int complemento);
 void proc_set_erro(process_t *proc, int erro);
-void proc_set_disk_address(process_t *proc, int disk_address);
+// aumenta a tabela de slots se preciso (as páginas novas ficam sem slot)
+void proc_set_swap_slot(process_t *proc, int pagina, int slot);
+// esquece a tabela de slots (os slots devem ser liberados antes)
+void proc_clear_swap_slots(process_t *proc);
+void proc_set_frame_list(process_t *proc, int frame);
+void proc_set_prefetch_window(process_t *proc, int window);
+void proc_set_sched_level(process_t *proc, int level);
+void proc_set_cpu(process_t *proc, int cpu);
+void proc_set_vruntime(process_t *proc, long vruntime);
+// limita o valor a [PROC_NICE_MIN, PROC_NICE_MAX]
+void proc_set_nice(process_t *proc, int nice);
+void proc_set_tab_pag(process_t *proc, tabpag_t *tab_pag);
 
 
 void proc_calc_priority(process_t *proc, int remaining_time, int default_time);
 void proc_increment_preemption(process_t *proc);
+// conta 'elapsed' instruções executadas no tempo virtual do processo,
+// ponderadas pelo peso do seu nice (com nice 0, o tempo virtual é o real)
+void proc_charge_vruntime(process_t *proc, int elapsed);
+// quantas instruções o processo ainda executa até o seu tempo virtual passar
+// de 'vruntime' (0 se já passou)
+int proc_instrucoes_ate_vruntime(process_t *proc, long vruntime);
 
 void proc_internal_tally(process_t *proc);
 
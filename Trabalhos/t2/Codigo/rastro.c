@@ -0,0 +1,100 @@
+// rastro.c
+// rastro de acessos à memória virtual
+// simulador de computador
+// so24b
+
+#include "rastro.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+struct rastro_t {
+  FILE *arq;
+  // último acesso, ainda não gravado (para juntar os repetidos), e quantas
+  //   vezes aconteceu
+  bool tem_pendente;
+  uint32_t pendente;
+  uint32_t repeticoes;
+};
+
+rastro_t *rastro_cria(char *nome)
+{
+  FILE *arq = fopen(nome, "wb");
+  if (arq == NULL) return NULL;
+
+  rastro_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+  self->arq = arq;
+  self->tem_pendente = false;
+  self->pendente = 0;
+  self->repeticoes = 0;
+  return self;
+}
+
+static void rastro__grava(rastro_t *self, uint32_t palavra)
+{
+  unsigned char b[4];
+  for (int i = 0; i < 4; i++) {
+    b[i] = (palavra >> (8 * i)) & 0xff;
+  }
+  fwrite(b, 1, 4, self->arq);
+}
+
+static void rastro__grava_pendente(rastro_t *self)
+{
+  rastro__grava(self, self->pendente);
+  rastro__grava(self, self->repeticoes);
+}
+
+void rastro_destroi(rastro_t *self)
+{
+  if (self->tem_pendente) rastro__grava_pendente(self);
+  fclose(self->arq);
+  free(self);
+}
+
+void rastro_registra(rastro_t *self, int asid, int pagina, bool escrita)
+{
+  if (asid < 0 || asid > RASTRO_MAX_ASID) return;
+  if (pagina < 0 || pagina > RASTRO_MAX_PAGINA) return;
+
+  uint32_t palavra = ((uint32_t)asid << 20) | ((uint32_t)pagina << 1);
+  if (self->tem_pendente && (self->pendente & ~1u) == palavra
+      && self->repeticoes < UINT32_MAX) {
+    if (escrita) self->pendente |= 1;
+    self->repeticoes++;
+    return;
+  }
+  if (self->tem_pendente) rastro__grava_pendente(self);
+  self->pendente = palavra | (escrita ? 1 : 0);
+  self->repeticoes = 1;
+  self->tem_pendente = true;
+}
+
+static bool rastro__le(FILE *arq, uint32_t *ppalavra)
+{
+  unsigned char b[4];
+  if (fread(b, 1, 4, arq) != 4) return false;
+
+  *ppalavra = 0;
+  for (int i = 0; i < 4; i++) {
+    *ppalavra |= (uint32_t)b[i] << (8 * i);
+  }
+  return true;
+}
+
+bool rastro_le(FILE *arq, int *pasid, int *ppagina, bool *pescrita,
+               long *prepeticoes)
+{
+  uint32_t palavra, repeticoes;
+  if (!rastro__le(arq, &palavra) || !rastro__le(arq, &repeticoes)) {
+    return false;
+  }
+
+  *pasid = palavra >> 20;
+  *ppagina = (palavra >> 1) & RASTRO_MAX_PAGINA;
+  *pescrita = palavra & 1;
+  *prepeticoes = repeticoes;
+  return true;
+}
@@ -0,0 +1,48 @@
+// rastro.h
+// rastro de acessos à memória virtual
+// simulador de computador
+// so24b
+
+#ifndef RASTRO_H
+#define RASTRO_H
+
+// a MMU pode gravar em um arquivo a sequência de acessos que traduziu, para
+//   que algoritmos de substituição de páginas sejam avaliados depois, sem
+//   executar de novo o simulador (ver simpag.c)
+// cada registro tem duas palavras de 32 bits (em little endian); a primeira é
+//   o acesso:
+//   bits 20-31: espaço de endereçamento (tabpag_asid), um por processo
+//   bits  1-19: página virtual
+//   bit      0: 1 se houve escrita
+// acessos seguidos à mesma página do mesmo espaço são gravados num registro
+//   só (com o bit de escrita se algum deles foi escrita), porque os repetidos
+//   não mudam as faltas de nenhum algoritmo de substituição; a segunda palavra
+//   é quantos acessos o registro representa, para a taxa de faltas
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define RASTRO_MAX_ASID 0xfff
+#define RASTRO_MAX_PAGINA 0x7ffff
+
+// tipo opaco que representa um rastro sendo gravado
+typedef struct rastro_t rastro_t;
+
+// cria um rastro gravando no arquivo 'nome'
+// retorna NULL se não conseguir criar o arquivo
+rastro_t *rastro_cria(char *nome);
+
+// grava o que falta e fecha o arquivo
+void rastro_destroi(rastro_t *self);
+
+// registra um acesso à página 'pagina' do espaço 'asid'
+// acessos fora dos limites do formato são ignorados
+void rastro_registra(rastro_t *self, int asid, int pagina, bool escrita);
+
+// lê o próximo registro de um arquivo de rastro, e quantos acessos seguidos ele
+//   representa
+// retorna false no final do arquivo
+bool rastro_le(FILE *arq, int *pasid, int *ppagina, bool *pescrita,
+               long *prepeticoes);
+
+#endif // RASTRO_H
@@ -25,6 +25,8 @@ relogio_t *relogio_cria(void)
   assert(self != NULL);
 
   self->agora = 0;
+  self->t_ate_interrupcao = 0;
+  self->interrupcao = 0;
 
   return self;
 }
@@ -46,6 +48,24 @@ void relogio_tictac(relogio_t *self)
   }
 }
 
+void relogio_avanca(relogio_t *self, int tics)
+{
+  self->agora += tics;
+  if (self->t_ate_interrupcao != 0) {
+    if (tics >= self->t_ate_interrupcao) {
+      self->t_ate_interrupcao = 0;
+      self->interrupcao = 1;
+    } else {
+      self->t_ate_interrupcao -= tics;
+    }
+  }
+}
+
+int relogio_tics_ate_interrupcao(relogio_t *self)
+{
+  return self->t_ate_interrupcao;
+}
+
 int relogio_agora(relogio_t *self)
 {
   return self->agora;
@@ -24,6 +24,14 @@ void relogio_destroi(relogio_t *self);
 // esta função é chamada pelo controlador após a execução de cada instrução
 void relogio_tictac(relogio_t *self);
 
+// registra a passagem de 'tics' unidades de tempo de uma vez
+// equivale a 'tics' chamadas a relogio_tictac
+void relogio_avanca(relogio_t *self, int tics);
+
+// retorna em quantas unidades de tempo o timer vai gerar uma interrupção,
+//   ou 0 se o timer estiver desligado
+int relogio_tics_ate_interrupcao(relogio_t *self);
+
 // retorna a hora atual do sistema, em unidades de tempo
 int relogio_agora(relogio_t *self);
 
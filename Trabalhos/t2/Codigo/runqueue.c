@@ -0,0 +1,180 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "runqueue.h"
+
+// cada nível é uma lista duplamente encadeada, com os ponteiros dentro dos
+// processos; o mapa tem o bit i ligado se o nível i não está vazio, e o nível
+// mais prioritário não vazio é o bit ligado menos significativo
+
+typedef struct
+{
+    process_t *head;
+    process_t *tail;
+    int size;
+} rq_level_t;
+
+struct runqueue_t
+{
+    int num_levels;
+    unsigned int nonempty;
+    rq_level_t levels[RUNQUEUE_MAX_LEVELS];
+};
+
+runqueue_t *runqueue_create(int levels)
+{
+    assert(levels > 0 && levels <= RUNQUEUE_MAX_LEVELS);
+
+    runqueue_t *rq = malloc(sizeof(runqueue_t));
+    assert(rq != NULL);
+
+    rq->num_levels = levels;
+    rq->nonempty = 0;
+    for (int i = 0; i < RUNQUEUE_MAX_LEVELS; i++)
+    {
+        rq->levels[i].head = NULL;
+        rq->levels[i].tail = NULL;
+        rq->levels[i].size = 0;
+    }
+
+    return rq;
+}
+
+void runqueue_destroy(runqueue_t *rq)
+{
+    // os processos não pertencem à fila
+    free(rq);
+}
+
+void runqueue_push(runqueue_t *rq, process_t *proc, int level)
+{
+    rq_node_t *node = proc_get_rq_node_ptr(proc);
+    assert(!node->queued);
+
+    if (level < 0) level = 0;
+    if (level >= rq->num_levels) level = rq->num_levels - 1;
+
+    rq_level_t *l = &rq->levels[level];
+    node->prev = l->tail;
+    node->next = NULL;
+    node->level = level;
+    node->queued = true;
+
+    if (l->tail != NULL)
+    {
+        proc_get_rq_node_ptr(l->tail)->next = proc;
+    }
+
+    else
+    {
+        l->head = proc;
+    }
+
+    l->tail = proc;
+    l->size++;
+    rq->nonempty |= 1u << level;
+}
+
+void runqueue_remove(runqueue_t *rq, process_t *proc)
+{
+    rq_node_t *node = proc_get_rq_node_ptr(proc);
+    if (!node->queued) return;
+
+    rq_level_t *l = &rq->levels[node->level];
+
+    if (node->prev != NULL)
+    {
+        proc_get_rq_node_ptr(node->prev)->next = node->next;
+    }
+
+    else
+    {
+        l->head = node->next;
+    }
+
+    if (node->next != NULL)
+    {
+        proc_get_rq_node_ptr(node->next)->prev = node->prev;
+    }
+
+    else
+    {
+        l->tail = node->prev;
+    }
+
+    l->size--;
+    if (l->size == 0)
+    {
+        rq->nonempty &= ~(1u << node->level);
+    }
+
+    node->prev = NULL;
+    node->next = NULL;
+    node->queued = false;
+}
+
+process_t *runqueue_peek(runqueue_t *rq)
+{
+    if (rq->nonempty == 0) return NULL;
+
+    int level = __builtin_ctz(rq->nonempty);
+    return rq->levels[level].head;
+}
+
+process_t *runqueue_peek_last(runqueue_t *rq)
+{
+    if (rq->nonempty == 0) return NULL;
+
+    int level = 31 - __builtin_clz(rq->nonempty);
+    return rq->levels[level].tail;
+}
+
+process_t *runqueue_prev(runqueue_t *rq, process_t *proc)
+{
+    rq_node_t *node = proc_get_rq_node_ptr(proc);
+    if (node->prev != NULL) return node->prev;
+
+    // o último do nível não vazio anterior, mais prioritário que o dele
+    unsigned int above = rq->nonempty & ((1u << node->level) - 1);
+    if (above == 0) return NULL;
+
+    return rq->levels[31 - __builtin_clz(above)].tail;
+}
+
+process_t *runqueue_pop(runqueue_t *rq)
+{
+    process_t *proc = runqueue_peek(rq);
+    if (proc != NULL)
+    {
+        runqueue_remove(rq, proc);
+    }
+
+    return proc;
+}
+
+bool runqueue_contains(process_t *proc)
+{
+    return proc_get_rq_node_ptr(proc)->queued;
+}
+
+int runqueue_level_of(process_t *proc)
+{
+    return proc_get_rq_node_ptr(proc)->level;
+}
+
+int runqueue_level_size(runqueue_t *rq, int level)
+{
+    return rq->levels[level].size;
+}
+
+int runqueue_size(runqueue_t *rq)
+{
+    int total = 0;
+    for (int i = 0; i < rq->num_levels; i++)
+    {
+        total += rq->levels[i].size;
+    }
+
+    return total;
+}
@@ -0,0 +1,55 @@
+#ifndef RUNQUEUE_H
+#define RUNQUEUE_H
+
+#include <stdbool.h>
+
+#include "proc.h"
+
+// fila de processos, com um nível por prioridade
+// usada como fila de prontos e (com um só nível) como fila de espera dos
+// processos bloqueados; um processo está em no máximo uma fila
+// a fila é intrusiva: os encadeamentos ficam no próprio processo (rq_node_t),
+// então inserir, retirar do início e retirar do meio são O(1), e não tem
+// alocação de memória nessas operações
+// o nível 0 é o mais prioritário; dentro de um nível a ordem é de chegada
+
+// número máximo de níveis (um bit por nível no mapa de níveis não vazios)
+#define RUNQUEUE_MAX_LEVELS 32
+
+typedef struct runqueue_t runqueue_t;
+
+runqueue_t *runqueue_create(int levels);
+void runqueue_destroy(runqueue_t *rq);
+
+// coloca o processo no final do nível 'level'
+// o processo não pode estar em nenhuma fila
+void runqueue_push(runqueue_t *rq, process_t *proc, int level);
+
+// retira o processo da fila onde ele está; não faz nada se não estiver em fila
+void runqueue_remove(runqueue_t *rq, process_t *proc);
+
+// retorna o primeiro processo do nível mais prioritário não vazio, ou NULL
+process_t *runqueue_peek(runqueue_t *rq);
+
+// retorna o último processo do nível menos prioritário não vazio (o último
+// que seria retirado), ou NULL
+process_t *runqueue_peek_last(runqueue_t *rq);
+
+// retorna o processo que vem antes de 'proc' (que deve estar na fila), na
+// ordem em que seriam retirados, ou NULL se ele é o primeiro
+process_t *runqueue_prev(runqueue_t *rq, process_t *proc);
+
+// retira e retorna o primeiro processo (o que seria retornado por peek)
+process_t *runqueue_pop(runqueue_t *rq);
+
+// retorna true se o processo está em alguma fila
+bool runqueue_contains(process_t *proc);
+
+// retorna o nível onde o processo está (só vale se estiver em fila)
+int runqueue_level_of(process_t *proc);
+
+// número de processos na fila, em um nível ou no total
+int runqueue_level_size(runqueue_t *rq, int level);
+int runqueue_size(runqueue_t *rq);
+
+#endif
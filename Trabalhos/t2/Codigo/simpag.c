@@ -0,0 +1,313 @@
+// simpag.c
+// simulador de algoritmos de substituição de páginas
+// simulador de computador
+// so24b
+
+// lê um rastro de acessos gravado pelo simulador (main -t rastro) e calcula,
+//   para vários números de quadros, a taxa de falta de páginas dos algoritmos
+//   FIFO, segunda chance (como no so.c), relógio, LRU e ótimo (Belady)
+// cada combinação de algoritmo e número de quadros é simulada independente
+//   das outras, e elas são divididas entre threads
+// a memória é global, como no SO: as páginas de todos os processos disputam
+//   os mesmos quadros
+
+// INCLUDES {{{1
+#include "rastro.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// AUXILIARES {{{1
+// aborta o programa com uma mensagem de erro
+static void erro_brabo(char *msg)
+{
+  fprintf(stderr, "ERRO FATAL: %s\n", msg);
+  exit(1);
+}
+
+static void *aloca(size_t tam)
+{
+  void *p = malloc(tam);
+  if (p == NULL) erro_brabo("falta de memória");
+  return p;
+}
+
+// RASTRO {{{1
+
+// o rastro, com as páginas renumeradas de 0 a n_paginas-1
+// cada acesso do vetor junta os acessos seguidos à mesma página (ver
+//   rastro.h); total_acessos é quantos foram antes de juntar
+static int n_acessos;
+static long total_acessos;
+static int n_paginas;
+static int *pagina;      // página de cada acesso
+static int *prox_uso;    // próximo acesso à mesma página (n_acessos se não tem)
+
+static int compara_u32(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void le_rastro(char *nome)
+{
+  FILE *arq = fopen(nome, "rb");
+  if (arq == NULL) erro_brabo("não foi possível abrir o rastro");
+
+  int cap = 1024;
+  uint32_t *chave = aloca(cap * sizeof(*chave));
+  int asid, pag;
+  bool escrita;
+  long repeticoes;
+  n_acessos = 0;
+  total_acessos = 0;
+  while (rastro_le(arq, &asid, &pag, &escrita, &repeticoes)) {
+    total_acessos += repeticoes;
+    if (n_acessos == cap) {
+      cap *= 2;
+      chave = realloc(chave, cap * sizeof(*chave));
+      if (chave == NULL) erro_brabo("falta de memória");
+    }
+    chave[n_acessos++] = ((uint32_t)asid << 19) | (uint32_t)pag;
+  }
+  fclose(arq);
+  if (n_acessos == 0) erro_brabo("rastro vazio");
+
+  // renumera as páginas: a posição da chave no vetor ordenado sem repetições
+  uint32_t *distintas = aloca(n_acessos * sizeof(*distintas));
+  for (int i = 0; i < n_acessos; i++) distintas[i] = chave[i];
+  qsort(distintas, n_acessos, sizeof(*distintas), compara_u32);
+  n_paginas = 0;
+  for (int i = 0; i < n_acessos; i++) {
+    if (n_paginas == 0 || distintas[n_paginas - 1] != distintas[i]) {
+      distintas[n_paginas++] = distintas[i];
+    }
+  }
+
+  pagina = aloca(n_acessos * sizeof(*pagina));
+  for (int i = 0; i < n_acessos; i++) {
+    uint32_t *p = bsearch(&chave[i], distintas, n_paginas, sizeof(*distintas),
+                          compara_u32);
+    pagina[i] = p - distintas;
+  }
+  free(chave);
+  free(distintas);
+
+  // o próximo uso de cada acesso, percorrendo o rastro de trás para frente
+  prox_uso = aloca(n_acessos * sizeof(*prox_uso));
+  int *ultimo = aloca(n_paginas * sizeof(*ultimo));
+  for (int p = 0; p < n_paginas; p++) ultimo[p] = n_acessos;
+  for (int i = n_acessos - 1; i >= 0; i--) {
+    prox_uso[i] = ultimo[pagina[i]];
+    ultimo[pagina[i]] = i;
+  }
+  free(ultimo);
+}
+
+// ALGORITMOS {{{1
+
+typedef enum { FIFO, SEGUNDA_CHANCE, RELOGIO, LRU, OTIMO, N_ALGORITMOS } algoritmo_t;
+static char *nome_alg[N_ALGORITMOS] = { "FIFO", "2a chance", "relógio", "LRU", "ótimo" };
+
+// estado dos quadros durante a simulação de um algoritmo
+typedef struct {
+  int n_quadros;
+  int *pagina_em;  // página em cada quadro
+  int *carga;      // quando a página foi colocada no quadro
+  int *uso;        // último acesso ao quadro
+  int *prox;       // próximo acesso à página do quadro
+  bool *ref;       // bit de acesso
+  int ponteiro;    // próximo quadro do FIFO ou do relógio
+} quadros_t;
+
+// escolhe o quadro cuja página vai ser substituída (todos estão ocupados)
+static int escolhe_vitima(algoritmo_t alg, quadros_t *q)
+{
+  int n = q->n_quadros;
+  int vitima = 0;
+  switch (alg) {
+    case FIFO:
+      vitima = q->ponteiro;
+      q->ponteiro = (q->ponteiro + 1) % n;
+      break;
+    case SEGUNDA_CHANCE:
+      // a mais antiga sem o bit de acesso; se todas têm, zera todos os bits
+      //   e escolhe a mais antiga
+      vitima = -1;
+      for (int i = 0; i < n; i++) {
+        if (!q->ref[i] && (vitima == -1 || q->carga[i] < q->carga[vitima])) {
+          vitima = i;
+        }
+      }
+      if (vitima == -1) {
+        vitima = 0;
+        for (int i = 0; i < n; i++) {
+          q->ref[i] = false;
+          if (q->carga[i] < q->carga[vitima]) vitima = i;
+        }
+      }
+      break;
+    case RELOGIO:
+      while (q->ref[q->ponteiro]) {
+        q->ref[q->ponteiro] = false;
+        q->ponteiro = (q->ponteiro + 1) % n;
+      }
+      vitima = q->ponteiro;
+      q->ponteiro = (q->ponteiro + 1) % n;
+      break;
+    case LRU:
+      for (int i = 1; i < n; i++) {
+        if (q->uso[i] < q->uso[vitima]) vitima = i;
+      }
+      break;
+    case OTIMO:
+      for (int i = 1; i < n; i++) {
+        if (q->prox[i] > q->prox[vitima]) vitima = i;
+      }
+      break;
+    default:
+      break;
+  }
+  return vitima;
+}
+
+// simula o algoritmo com n_quadros, retorna o número de faltas de página
+static long simula(algoritmo_t alg, int n_quadros)
+{
+  quadros_t q;
+  q.n_quadros = n_quadros;
+  q.pagina_em = aloca(n_quadros * sizeof(int));
+  q.carga = aloca(n_quadros * sizeof(int));
+  q.uso = aloca(n_quadros * sizeof(int));
+  q.prox = aloca(n_quadros * sizeof(int));
+  q.ref = aloca(n_quadros * sizeof(bool));
+  q.ponteiro = 0;
+  int *quadro_de = aloca(n_paginas * sizeof(int));
+  for (int p = 0; p < n_paginas; p++) quadro_de[p] = -1;
+
+  long faltas = 0;
+  int ocupados = 0;
+  for (int t = 0; t < n_acessos; t++) {
+    int p = pagina[t];
+    int i = quadro_de[p];
+    if (i == -1) {
+      faltas++;
+      if (ocupados < n_quadros) {
+        i = ocupados++;
+      } else {
+        i = escolhe_vitima(alg, &q);
+        quadro_de[q.pagina_em[i]] = -1;
+      }
+      q.pagina_em[i] = p;
+      q.carga[i] = t;
+      quadro_de[p] = i;
+    }
+    q.uso[i] = t;
+    q.prox[i] = prox_uso[t];
+    q.ref[i] = true;
+  }
+
+  free(q.pagina_em);
+  free(q.carga);
+  free(q.uso);
+  free(q.prox);
+  free(q.ref);
+  free(quadro_de);
+  return faltas;
+}
+
+// THREADS {{{1
+
+// cada trabalho é um par (algoritmo, número de quadros); as threads pegam o
+//   próximo trabalho não feito até acabarem
+static int min_quadros, max_quadros;
+static int n_trabalhos;
+static int prox_trabalho;
+static long *resultado;  // faltas de cada trabalho
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+static void *executa_trabalhos(void *arg)
+{
+  (void)arg;
+  for (;;) {
+    pthread_mutex_lock(&trava);
+    int trab = prox_trabalho++;
+    pthread_mutex_unlock(&trava);
+    if (trab >= n_trabalhos) break;
+
+    int n_quadros = min_quadros + trab / N_ALGORITMOS;
+    algoritmo_t alg = trab % N_ALGORITMOS;
+    resultado[trab] = simula(alg, n_quadros);
+  }
+  return NULL;
+}
+
+// PRINCIPAL {{{1
+
+static void verifica_args(int argc, char *argv[argc], char **pnome)
+{
+  if (argc < 2 || argc > 4) {
+    fprintf(stderr, "ERRO: chame como '%s rastro [min_quadros [max_quadros]]'\n",
+            argv[0]);
+    exit(1);
+  }
+  *pnome = argv[1];
+  min_quadros = argc > 2 ? atoi(argv[2]) : 1;
+  max_quadros = argc > 3 ? atoi(argv[3]) : 32;
+  if (min_quadros < 1 || max_quadros < min_quadros) {
+    erro_brabo("número de quadros inválido");
+  }
+}
+
+int main(int argc, char *argv[argc])
+{
+  char *nome;
+  verifica_args(argc, argv, &nome);
+  le_rastro(nome);
+
+  n_trabalhos = (max_quadros - min_quadros + 1) * N_ALGORITMOS;
+  resultado = aloca(n_trabalhos * sizeof(*resultado));
+  prox_trabalho = 0;
+
+  long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n_threads < 1) n_threads = 1;
+  if (n_threads > n_trabalhos) n_threads = n_trabalhos;
+  pthread_t *threads = aloca(n_threads * sizeof(*threads));
+  for (int i = 0; i < n_threads; i++) {
+    if (pthread_create(&threads[i], NULL, executa_trabalhos, NULL) != 0) {
+      erro_brabo("não foi possível criar thread");
+    }
+  }
+  for (int i = 0; i < n_threads; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  // uma linha por número de quadros, com a porcentagem de acessos que falta
+  //   (contando os repetidos, que nunca faltam)
+  printf("# %ld acessos (%d sem as repetições), %d páginas distintas\n",
+         total_acessos, n_acessos, n_paginas);
+  printf("# quadros");
+  for (int a = 0; a < N_ALGORITMOS; a++) printf(" %10s", nome_alg[a]);
+  printf("\n");
+  for (int n = min_quadros; n <= max_quadros; n++) {
+    printf("%9d", n);
+    for (int a = 0; a < N_ALGORITMOS; a++) {
+      long faltas = resultado[(n - min_quadros) * N_ALGORITMOS + a];
+      printf(" %9.2f%%", 100.0 * faltas / total_acessos);
+    }
+    printf("\n");
+  }
+
+  free(threads);
+  free(resultado);
+  free(pagina);
+  free(prox_uso);
+  return 0;
+}
+
+// vim: foldmethod=marker
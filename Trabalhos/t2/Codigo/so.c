@@ -11,14 +11,18 @@
 #include "tabpag.h"
 #include "instrucao.h"
 #include "proc.h"
-#include "list.h"
+#include "runqueue.h"
+#include "vrqueue.h"
 #include "mem_block.h"
+#include "frame_alloc.h"
+#include "swap.h"
+#include "disco.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
-#include <math.h>
 
 #define MAX_PROC 16
 
@@ -27,28 +31,208 @@
 #define SCHEDULER_TYPE0 0
 #define SCHEDULER_TYPE1 1
 #define SCHEDULER_TYPE2 2
+#define SCHEDULER_TYPE3 3
+#define SCHEDULER_TYPE4 4
 
-#define SWAP_ALGORITHM 2    // escolha o tipo de escalonador
+// níveis da fila de prontos; o escalonador tipo 2 coloca cada processo no
+// nível correspondente à sua prioridade, o tipo 3 no seu nível do MLFQ, os
+// outros usam só o nível 0
+#define RUNQUEUE_LEVELS 8
+
+// escalonador tipo 3 (MLFQ): número de níveis usados, quantum de cada nível
+// (em instruções; dobra a cada nível) e a cada quantas manutenções periódicas
+// (so_trata_irq_relogio) todos os processos voltam para o nível 0
+#define MLFQ_NIVEIS 4
+#define MLFQ_QUANTUM(nivel) ((DEFAULT_QUANTUM / 2) << (nivel))
+#define MLFQ_INTERVALO_IMPULSO 50
+
+// escalonador tipo 4 (justo, como o CFS do Linux): executa o processo pronto
+// de menor tempo virtual (instruções executadas, ponderadas pelo nice); o
+// corrente perde a CPU quando esgota o quantum ou quando fica mais de
+// CFS_GRANULARIDADE à frente do primeiro da fila, e quem acorda fica no máximo
+// CFS_CREDITO_ACORDAR atrás do menor tempo virtual da CPU
+#define CFS_GRANULARIDADE (2 * INTERVALO_INTERRUPCAO)
+#define CFS_CREDITO_ACORDAR (DEFAULT_QUANTUM / 2)
+
+#define N_TERMINAIS 4
+
+#define SWAP_ALGORITHM 2    // escolha o algoritmo de substituição de páginas
 
 #define EXTRADUMB_REMOVAL 0
 #define FIFO 1
 #define SECOND_CHANCE 2
+#define CLOCK 3
+#define AGING 4
 
-// CONSTANTES DE EXECUÇÃO
-#define DEFAULT_QUANTUM 10
-#define INTERVALO_INTERRUPCAO 100   // em instruções executadas
-#define TEMPO_BLOQUEIO_DISCO 2
+#define DISK_SCHEDULER 4    // escolha o escalonador de pedidos ao disco
 
-#define TYPES_OF_IRQS 6
+#define DISK_FCFS 1
+#define DISK_SSTF 2
+#define DISK_SCAN 3
+#define DISK_C_LOOK 4
 
+// CONSTANTES DE EXECUÇÃO
+#define INTERVALO_INTERRUPCAO 100   // em instruções executadas
+#define DEFAULT_QUANTUM (10 * INTERVALO_INTERRUPCAO)   // em instruções executadas
+// timer sob demanda: o timer é programado para o próximo prazo útil (fim de um
+// quantum ou próxima manutenção periódica), e fica desligado se não há nenhum
+// (so_programa_relogio); com 0, interrompe sempre a cada INTERVALO_INTERRUPCAO
+#define TIMER_DINAMICO 1
+#define TAM_DISCO 10000          // tamanho inicial do disco; dobra quando enche
+#define ARQUIVO_DISCO "disco_swap" // arquivo com o conteúdo do disco
+
+// paginador (so_pager): quantas páginas alteradas grava no disco a cada
+// interrupção do relógio, e quantos quadros tenta manter livres
+#define PAGER_LOTE_ESCRITA 2
+#define PAGER_QUADROS_LIVRES 1
+
+// leitura antecipada (so_antecipa_paginas): janela inicial de cada processo,
+// e a maior janela (0 desliga a leitura antecipada)
+#define PREFETCH_JANELA_INICIAL 1
+#define PREFETCH_JANELA_MAX 4
+
+#define TYPES_OF_IRQS N_IRQ
+
+
+// programa já carregado na memória secundária, para ser compartilhado por
+//   todos os processos que o executam (a imagem tem uma referência aos slots,
+//   e é descartada quando nenhum processo usa mais, so_descarta_imagens_sem_uso)
+typedef struct
+{
+  char nome[100];
+  int num_pages;
+  int *slots;
+} so_imagem_t;
+
+// pedido de acesso ao disco, na fila ou sendo atendido pela controladora
+// os dados são copiados quando o pedido é feito; o pedido representa o tempo
+//   que o disco leva para fazer a transferência
+typedef struct
+{
+  int slot;
+  int quantidade;
+  bool escrita;
+  // processo bloqueado esperando o fim do pedido, NULL se ninguém espera
+  //   (gravação de página alterada)
+  process_t *proc;
+  // relógio quando o pedido foi feito
+  int chegada;
+} so_pedido_disco_t;
+
+// o que o SO sabe de cada CPU
+// enquanto o SO atende uma interrupção de uma CPU, o processo corrente, o
+//   quantum e o início do ócio dela ficam nos campos correspondentes do so_t
+//   (so_entra_na_cpu e so_sai_da_cpu), e o resto do SO não precisa saber
+//   qual CPU está atendendo
+typedef struct
+{
+  so_t *so;
+  int id;
+  cpu_t *cpu;
+  mmu_t *mmu;
+  // onde a CPU salva o estado do processo interrompido (IRQ_END_* é relativo)
+  int area_irq;
+  // fila de prontos da CPU; o processo corrente também fica nela
+  runqueue_t *queue;
+  // escalonador justo: os prontos da CPU por tempo virtual (sem o corrente),
+  //   e o menor tempo virtual da CPU, que só cresce
+  vrqueue_t *vr_queue;
+  long min_vruntime;
+  process_t *current_process;
+  // o quantum que resta ao processo corrente, em instruções, e quantas
+  //   instruções executadas pela CPU já foram descontadas dele
+  int quantum;
+  int instrucoes_cobradas;
+  int idle_since;
+  // o processo corrente foi morto por outra CPU; ele ainda está executando
+  //   aqui, e só morre quando esta CPU entrar no SO
+  bool mata_corrente;
+  // interrupções atendidas, tempo parada e processos roubados de outras
+  //   CPUs, para as métricas
+  int interrupts;
+  int idle_time;
+  int steals;
+  // disputa pelo SO: quantas vezes a CPU tinha aceitado uma interrupção e
+  //   teve que esperar outra CPU sair do SO para ser atendida (uma vez para
+  //   cada CPU atendida antes dela)
+  int kernel_waits;
+} so_cpu_t;
 
 struct sys_metrics_t 
 {
   int total_processes;
   int total_runtime;
   int total_halted_time;
+  int total_idle_time;
   int *interrupts;
   int preemptions;
+
+  // substituição de páginas pelo relógio: quantas escolhas de vítima, quantos
+  // quadros o ponteiro percorreu no total e na escolha mais longa
+  int clock_selections;
+  int clock_scanned;
+  int clock_max_scan;
+
+  // páginas alteradas gravadas no disco durante a falta de página e pelo
+  // paginador, e quadros liberados pelo paginador
+  int sync_writebacks;
+  int pager_writebacks;
+  int pager_evictions;
+
+  // maior número de slots de swap ocupados ao mesmo tempo
+  int max_swap_slots;
+
+  // leitura antecipada: páginas trazidas antes de serem pedidas, e quantas
+  // delas foram usadas e quantas saíram da memória sem serem usadas
+  int prefetch_pages;
+  int prefetch_hits;
+  int prefetch_wasted;
+
+  // quadros compartilhados: faltas resolvidas mapeando o quadro de outro
+  // processo, cópias feitas na escrita e quadros que deixaram de ser
+  // compartilhados sem cópia (só um processo os mapeava)
+  int shared_maps;
+  int cow_copies;
+  int cow_unshares;
+
+  // escalonador MLFQ: tempo executando e tempo pronto em cada nível,
+  // quantas vezes um processo desceu (quantum esgotado) ou subiu (bloqueou
+  // esperando um terminal) de nível, e quantos impulsos para o nível 0
+  int mlfq_executing_time[MLFQ_NIVEIS];
+  int mlfq_ready_time[MLFQ_NIVEIS];
+  int mlfq_demotions;
+  int mlfq_promotions;
+  int mlfq_boosts;
+
+  // escalonador justo: quantas vezes o corrente perdeu a CPU por ficar à
+  // frente de outro no tempo virtual (antes de esgotar o quantum)
+  int cfs_preemptions;
+
+  // duplicação de processos (SO_FORK): quantas, quantas páginas que estavam
+  // na memória ficaram compartilhadas entre pai e filho, e quantas páginas
+  // alteradas do pai foram gravadas para poderem ser compartilhadas
+  int forks;
+  int fork_shared_pages;
+  int fork_writebacks;
+
+  // processos roubados da fila de outra CPU, e quantas vezes um processo que
+  // já tinha executado passou a executar em outra CPU
+  int steals;
+  int migrations;
+
+  // entradas no SO em que alguma outra CPU ficou esperando por ele
+  int contended_entries;
+
+  // pedidos atendidos pelo disco, trilhas percorridas pelo braço, tempo
+  // total entre o pedido e o fim do atendimento e maior fila de pedidos
+  int disk_reads;
+  int disk_writes;
+  int disk_seek_tracks;
+  int disk_wait_time;
+  int disk_max_queue;
+
+  // tempo com o timer desligado por não ter utilidade (TIMER_DINAMICO)
+  int timer_off_time;
 };
 
 // Não tem processos nem memória virtual, mas é preciso usar a paginação,
@@ -72,30 +256,82 @@ struct sys_metrics_t
 #define NENHUM_PROCESSO NULL
 
 struct so_t {
+  // as CPUs, e a que está sendo atendida; cpu e mmu são as dela
+  so_cpu_t *cpus;
+  int n_cpus;
+  so_cpu_t *cpu_atual;
   cpu_t *cpu;
   mem_t *mem;
   mmu_t *mmu;
   es_t *es;
   console_t *console;
+  // programa executado pelo primeiro processo
+  char *programa_inicial;
   bool erro_interno;
+  // a simulação foi parada (todos os processos morreram)
+  bool desligado;
 
   process_t **process_table;
+  // processo corrente da CPU em atendimento
   process_t *current_process;
 
   int process_counter;
   int process_slots;
 
-  list *queue;
+  // fila de prontos e quantum da CPU em atendimento
+  runqueue_t *queue;
   int quantum;
+  // manutenções periódicas desde o último impulso do MLFQ, e relógio da
+  //   última manutenção
+  int tics_desde_impulso;
+  int ultima_manutencao;
+
+  // filas de espera dos processos bloqueados, uma por recurso, para que só
+  // os processos esperando por algo que mudou sejam olhados:
+  // - leitura e escrita, uma fila para cada terminal
+  // - fim de processo, uma fila por pid esperado (criada quando alguém espera)
+  // - disco: os que esperam a leitura de uma página, e os que esperam que
+  //   algum quadro deixe de estar preso por uma leitura em andamento
+  runqueue_t *wait_teclado[N_TERMINAIS];
+  runqueue_t *wait_tela[N_TERMINAIS];
+  runqueue_t **wait_proc;
+  runqueue_t *wait_disco;
+  runqueue_t *wait_quadro;
+
+  // pedidos ao disco esperando a controladora, em ordem de chegada, o pedido
+  //   sendo atendido e o sentido em que o braço está andando (para o SCAN)
+  so_pedido_disco_t *fila_disco;
+  int tam_fila_disco;
+  int cap_fila_disco;
+  so_pedido_disco_t disco_em_uso;
+  bool disco_ocupado;
+  int sentido_disco;
 
   sys_metrics_t metrics;
   int latest_clock;
-
-  mem_t *disk;
-  int disk_pointer; // próximo valor livre de escrita no disco
+  // relógio quando a CPU em atendimento foi parada por falta de processo, -1
+  //   se não está
+  int idle_since;
+  // relógio quando o timer foi desligado, -1 se está ligado
+  int timer_off_since;
+
+  // memória secundária, dividida em slots de uma página
+  // as páginas de um programa carregado ficam em slots compartilhados pelos
+  // processos que executam esse programa, até serem alteradas
+  disco_t *disk;
+  swap_t *swap;
+  so_imagem_t *imagens;
+  int num_imagens;
 
   mem_block_t *mem_tracker;
+  // quadro com a página (não alterada) de cada slot compartilhado, -1 se não
+  //   está na memória; tem uma posição por slot do disco
+  int *quadro_do_slot;
+  // quadros livres; os ocupados estão no mem_tracker e na lista do processo dono
+  frame_alloc_t *frames;
   int num_physical_pages;
+  // ponteiro do algoritmo do relógio: próximo quadro a ser examinado
+  int clock_hand;
 };
 
 
@@ -110,6 +346,22 @@ static int so_carrega_programa(so_t *self, process_t *processo,
 // copia para str da memória do processo, até copiar um 0 (retorna true) ou tam bytes
 static bool so_copia_str_do_processo(so_t *self, int tam, char str[tam],
                                      int end_virt, process_t *processo);
+// memória secundária: ocupa um slot, traduz página ou endereço virtual para o
+//   disco, copia páginas entre disco e memória, libera os slots de um processo
+static int so_aloca_slot(so_t *self);
+static int so_slot_disco(so_t *self, process_t *proc, int pagina, bool escrita);
+static int so_end_disco(so_t *self, process_t *proc, int end_virt, bool escrita);
+static err_t so_copia_disco_para_quadro(so_t *self, int slot, int quadro);
+static err_t so_copia_quadro_para_disco(so_t *self, int quadro, int slot);
+static void so_libera_swap_do_processo(so_t *self, process_t *proc);
+static void so_descarta_imagens_sem_uso(so_t *self);
+// leitura antecipada: conta se a página antecipada no quadro foi usada, ou se
+//   foi desperdiçada quando ela sai da memória
+static void so_confere_antecipacao(so_t *self, int quadro);
+static void so_encerra_antecipacao(so_t *self, int quadro, bool reduz);
+// escrita numa página compartilhada: separa a página do processo
+static bool so_quebra_compartilhamento(so_t *self, process_t *proc, int pagina);
+static bool so_pagina_gravavel(so_t *self, process_t *proc, int pagina);
 
 // CRIAÇÃO {{{1
 
@@ -121,43 +373,159 @@ sys_metrics_t so_inicializa_metricas(so_t *self)
   metrics.total_processes = 0;
   metrics.total_runtime = 0;
   metrics.total_halted_time = 0;
-  metrics.interrupts = (int *)malloc(TYPES_OF_IRQS * sizeof(int));
+  metrics.total_idle_time = 0;
+  metrics.interrupts = (int *)calloc(TYPES_OF_IRQS, sizeof(int));
   metrics.preemptions = 0;
+  metrics.clock_selections = 0;
+  metrics.clock_scanned = 0;
+  metrics.clock_max_scan = 0;
+  metrics.sync_writebacks = 0;
+  metrics.pager_writebacks = 0;
+  metrics.pager_evictions = 0;
+  metrics.max_swap_slots = 0;
+  metrics.prefetch_pages = 0;
+  metrics.prefetch_hits = 0;
+  metrics.prefetch_wasted = 0;
+  metrics.shared_maps = 0;
+  metrics.cow_copies = 0;
+  metrics.cow_unshares = 0;
+  for (int nivel = 0; nivel < MLFQ_NIVEIS; nivel++)
+  {
+    metrics.mlfq_executing_time[nivel] = 0;
+    metrics.mlfq_ready_time[nivel] = 0;
+  }
+  metrics.mlfq_demotions = 0;
+  metrics.mlfq_promotions = 0;
+  metrics.mlfq_boosts = 0;
+  metrics.cfs_preemptions = 0;
+  metrics.forks = 0;
+  metrics.fork_shared_pages = 0;
+  metrics.fork_writebacks = 0;
+  metrics.steals = 0;
+  metrics.migrations = 0;
+  metrics.contended_entries = 0;
+  metrics.disk_reads = 0;
+  metrics.disk_writes = 0;
+  metrics.disk_seek_tracks = 0;
+  metrics.disk_wait_time = 0;
+  metrics.disk_max_queue = 0;
+  metrics.timer_off_time = 0;
 
   return metrics;
 }
 
-so_t *so_cria(cpu_t *cpu, mem_t *mem, mmu_t *mmu,
-              es_t *es, console_t *console)
+so_t *so_cria(int n_cpus, cpu_t *cpus[n_cpus], mmu_t *mmus[n_cpus],
+              mem_t *mem, es_t *es, console_t *console,
+              char *programa_inicial)
 {
   so_t *self = malloc(sizeof(*self));
   assert(self != NULL);
 
-  self->cpu = cpu;
+  self->n_cpus = n_cpus;
+  self->cpus = malloc(n_cpus * sizeof(so_cpu_t));
+  assert(self->cpus != NULL);
+  for (int i = 0; i < n_cpus; i++)
+  {
+    so_cpu_t *cpu = &self->cpus[i];
+    cpu->so = self;
+    cpu->id = i;
+    cpu->cpu = cpus[i];
+    cpu->mmu = mmus[i];
+    cpu->area_irq = cpu_area_irq(cpus[i]);
+    cpu->queue = runqueue_create(RUNQUEUE_LEVELS);
+    cpu->vr_queue = vrqueue_create();
+    cpu->min_vruntime = 0;
+    cpu->current_process = NULL;
+    cpu->quantum = DEFAULT_QUANTUM;
+    cpu->instrucoes_cobradas = 0;
+    cpu->idle_since = -1;
+    cpu->mata_corrente = false;
+    cpu->interrupts = 0;
+    cpu->idle_time = 0;
+    cpu->steals = 0;
+    cpu->kernel_waits = 0;
+  }
+  // até a primeira interrupção, a CPU 0 faz as vezes de CPU em atendimento
+  self->cpu_atual = &self->cpus[0];
+  self->cpu = cpus[0];
+  self->mmu = mmus[0];
+  self->queue = self->cpus[0].queue;
   self->mem = mem;
-  self->disk = mem_cria(10000);
-  self->mmu = mmu;
+  self->disk = disco_cria(ARQUIVO_DISCO, TAM_PAGINA, TAM_DISCO / TAM_PAGINA);
+  if (self->disk == NULL) {
+    // sem memória secundária não tem como executar processos
+    fprintf(stderr, "ERRO: não foi possível criar o disco '%s'\n", ARQUIVO_DISCO);
+    exit(1);
+  }
+  self->swap = swap_create(TAM_DISCO / TAM_PAGINA);
+  self->imagens = NULL;
+  self->num_imagens = 0;
   self->es = es;
   self->console = console;
+  self->programa_inicial = programa_inicial;
   self->erro_interno = false;
+  self->desligado = false;
 
-  self->disk_pointer = 0;
-  self->num_physical_pages = mem_tam(self->mem)/TAM_PAGINA;
+  // as áreas de salvamento das outras CPUs ficam depois da memória dos
+  //   processos (a da primeira fica no início, em quadro reservado); os
+  //   quadros vão até a primeira delas
+  int tam_mem_processos = mem_tam(self->mem);
+  for (int i = 1; i < n_cpus; i++)
+  {
+    if (self->cpus[i].area_irq < tam_mem_processos)
+    {
+      tam_mem_processos = self->cpus[i].area_irq;
+    }
+  }
+  self->num_physical_pages = tam_mem_processos/TAM_PAGINA;
   self->mem_tracker = create_mem_blocks(self->num_physical_pages);
+  self->frames = frame_alloc_create(self->num_physical_pages);
+  self->quadro_do_slot = malloc(swap_num_slots(self->swap) * sizeof(int));
+  assert(self->quadro_do_slot != NULL);
+  for (int i = 0; i < swap_num_slots(self->swap); i++)
+  {
+    self->quadro_do_slot[i] = -1;
+  }
+  self->clock_hand = 0;
+  for (int i = 0; i < self->num_physical_pages; i++)
+  {
+    if (self->mem_tracker[i].used) frame_alloc_take(self->frames, i);
+  }
 
   self->process_slots = MAX_PROC;
   self->process_table = malloc(self->process_slots * sizeof(process_t *));
   self->current_process = NULL;
   self->process_counter = 1;
+  self->latest_clock = 0;
+  self->idle_since = -1;
+  self->timer_off_since = -1;
 
-  self->queue = list_create();  
+  for (int t = 0; t < N_TERMINAIS; t++)
+  {
+    self->wait_teclado[t] = runqueue_create(1);
+    self->wait_tela[t] = runqueue_create(1);
+  }
+  self->wait_proc = calloc(self->process_slots, sizeof(runqueue_t *));
+  self->wait_disco = runqueue_create(1);
+  self->wait_quadro = runqueue_create(1);
+  self->fila_disco = NULL;
+  self->tam_fila_disco = 0;
+  self->cap_fila_disco = 0;
+  self->disco_ocupado = false;
+  self->sentido_disco = 1;
   self->quantum = DEFAULT_QUANTUM;
+  self->tics_desde_impulso = 0;
+  self->ultima_manutencao = 0;
 
   self->metrics = so_inicializa_metricas(self);
 
-  // quando a CPU executar uma instrução CHAMAC, deve chamar a função
-  //   so_trata_interrupcao, com primeiro argumento um ptr para o SO
-  cpu_define_chamaC(self->cpu, so_trata_interrupcao, self);
+  // quando uma CPU executar uma instrução CHAMAC, deve chamar a função
+  //   so_trata_interrupcao, com primeiro argumento um ptr para o que o SO
+  //   sabe dessa CPU (que aponta para o SO)
+  for (int i = 0; i < n_cpus; i++)
+  {
+    cpu_define_chamaC(self->cpus[i].cpu, so_trata_interrupcao, &self->cpus[i]);
+  }
 
   // coloca o tratador de interrupção na memória
   // quando a CPU aceita uma interrupção, passa para modo supervisor, 
@@ -184,7 +552,36 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, mmu_t *mmu,
 
 void so_destroi(so_t *self)
 {
-  cpu_define_chamaC(self->cpu, NULL, NULL);
+  for (int i = 0; i < self->n_cpus; i++)
+  {
+    cpu_define_chamaC(self->cpus[i].cpu, NULL, NULL);
+    runqueue_destroy(self->cpus[i].queue);
+    vrqueue_destroy(self->cpus[i].vr_queue);
+  }
+  free(self->cpus);
+  for (int t = 0; t < N_TERMINAIS; t++)
+  {
+    runqueue_destroy(self->wait_teclado[t]);
+    runqueue_destroy(self->wait_tela[t]);
+  }
+  for (int i = 0; i < self->process_slots; i++)
+  {
+    if (self->wait_proc[i] != NULL) runqueue_destroy(self->wait_proc[i]);
+  }
+  free(self->wait_proc);
+  runqueue_destroy(self->wait_disco);
+  runqueue_destroy(self->wait_quadro);
+  free(self->fila_disco);
+  frame_alloc_destroy(self->frames);
+  free(self->mem_tracker);
+  free(self->quadro_do_slot);
+  for (int i = 0; i < self->num_imagens; i++)
+  {
+    free(self->imagens[i].slots);
+  }
+  free(self->imagens);
+  swap_destroy(self->swap);
+  disco_destroi(self->disk);
   free(self);
 }
 
@@ -193,6 +590,7 @@ void so_update_metrics(so_t *self, int irq)
 {
   // métrica de tipo de interrupção
   self->metrics.interrupts[irq]++;
+  self->cpu_atual->interrupts++;
 
   // métricas de tempo
   int last_clock = self->latest_clock;
@@ -204,6 +602,14 @@ void so_update_metrics(so_t *self, int irq)
 
   int elapsed_time = self->latest_clock - last_clock;
 
+  // a CPU estava parada desde o último despacho sem processo
+  if (self->idle_since != -1)
+  {
+    self->metrics.total_idle_time += self->latest_clock - self->idle_since;
+    self->cpu_atual->idle_time += self->latest_clock - self->idle_since;
+    self->idle_since = -1;
+  }
+
   for (int i = 1; i < self->process_counter; i++)
   {
     process_t *proc = self->process_table[i];
@@ -214,10 +620,13 @@ void so_update_metrics(so_t *self, int irq)
       {
         case PROC_EXECUTANDO:
           metrics->executing_time += elapsed_time;
+          proc_charge_vruntime(proc, elapsed_time);
+          self->metrics.mlfq_executing_time[proc_get_sched_level(proc)] += elapsed_time;
           break;
 
         case PROC_PRONTO:
           metrics->ready_time += elapsed_time;
+          self->metrics.mlfq_ready_time[proc_get_sched_level(proc)] += elapsed_time;
           break;
 
         case PROC_BLOQUEADO:
@@ -240,7 +649,9 @@ void so_display_pagefaults_count(so_t *self)
   for (int i = 1; i < self->process_counter; i++)
   {
     console_printf("    -> Processo #%02d", i);
-    console_printf("       = %d page faults", proc_get_metrics_ptr(self->process_table[i])->page_faults);
+    proc_metrics_t *metrics = proc_get_metrics_ptr(self->process_table[i]);
+    console_printf("       = %d page faults", metrics->page_faults);
+    console_printf("       = %d quadros ocupados no máximo", metrics->max_resident_pages);
   }
 }
 
@@ -249,13 +660,21 @@ void so_display_pagefaults_count(so_t *self)
 // TRATAMENTO DE INTERRUPÇÃO {{{1
 
 // funções auxiliares para o tratamento de interrupção
+static void so_conta_disputa(so_t *self, so_cpu_t *cpu);
+static void so_entra_na_cpu(so_t *self, so_cpu_t *cpu);
+static void so_sai_da_cpu(so_t *self);
+static void so_desconta_quantum(so_t *self);
+static int so_atende_interrupcao(so_t *self, irq_t irq);
+static void so_mata_proc(so_t *self, process_t *killed);
 static void so_salva_estado_da_cpu(so_t *self);
 static void so_trata_irq(so_t *self, int irq);
 static void so_trata_pendencias(so_t *self);
 static void so_escalona(so_t *self);
+static void so_programa_relogio(so_t *self);
 static int so_despacha(so_t *self);
 int so_suicide(so_t *self);
 bool is_any_proc_alive(so_t *self);
+void so_show_metrics(so_t *self);
 
 
 // função a ser chamada pela CPU quando executa a instrução CHAMAC, no tratador de
@@ -274,11 +693,86 @@ bool is_any_proc_alive(so_t *self);
 //   outra interrupção
 static int so_trata_interrupcao(void *argC, int reg_A)
 {
-  so_t *self = argC;
-  irq_t irq = reg_A;
+  so_cpu_t *cpu = argC;
+  so_t *self = cpu->so;
+
+  so_conta_disputa(self, cpu);
+  so_entra_na_cpu(self, cpu);
+  int ret = so_atende_interrupcao(self, reg_A);
+  so_sai_da_cpu(self);
+
+  return ret;
+}
+
+// disputa pelo SO: ele atende uma CPU de cada vez, então as outras CPUs que
+//   já aceitaram uma interrupção (mas não chamaram o SO) esperam esta sair,
+//   como esperariam por uma trava única do núcleo; isso acontece principalmente
+//   com a interrupção do relógio, que chega a todas as CPUs ao mesmo tempo
+static void so_conta_disputa(so_t *self, so_cpu_t *cpu)
+{
+  bool disputada = false;
+  for (int i = 0; i < self->n_cpus; i++)
+  {
+    so_cpu_t *outra = &self->cpus[i];
+    if (outra != cpu && cpu_entrando_no_tratador(outra->cpu))
+    {
+      outra->kernel_waits++;
+      disputada = true;
+    }
+  }
+  if (disputada) self->metrics.contended_entries++;
+}
+
+// traz o estado do SO nessa CPU para o so_t
+static void so_entra_na_cpu(so_t *self, so_cpu_t *cpu)
+{
+  self->cpu_atual = cpu;
+  self->cpu = cpu->cpu;
+  self->mmu = cpu->mmu;
+  self->queue = cpu->queue;
+  self->current_process = cpu->current_process;
+  self->quantum = cpu->quantum;
+  self->idle_since = cpu->idle_since;
+}
+
+// devolve o estado do SO na CPU em atendimento para ela
+static void so_sai_da_cpu(so_t *self)
+{
+  so_cpu_t *cpu = self->cpu_atual;
+  cpu->current_process = self->current_process;
+  cpu->quantum = self->quantum;
+  cpu->idle_since = self->idle_since;
+}
+
+// desconta do quantum do processo corrente as instruções que a CPU executou
+//   desde a última entrada dela no SO: as dele, e as do tratador de
+//   interrupção na saída e na volta para o SO, que ele também paga (senão
+//   um timer que expira dentro do tratador não descontaria nada)
+static void so_desconta_quantum(so_t *self)
+{
+  so_cpu_t *cpu = self->cpu_atual;
+  int executadas = cpu_instrucoes_executadas(cpu->cpu) - cpu->instrucoes_cobradas;
+  cpu->instrucoes_cobradas += executadas;
+  if (self->current_process == NULL) return;
+
+  self->quantum -= executadas;
+  if (self->quantum < 0) self->quantum = 0;
+}
+
+static int so_atende_interrupcao(so_t *self, irq_t irq)
+{
+  // depois de parar a simulação, ainda podem vir interrupções dos terminais,
+  //   e do disco terminando gravações que estavam na fila; não tem mais nada
+  //   a fazer com elas, só desligar o pedido de interrupção do disco
+  if (self->desligado)
+  {
+    if (irq == IRQ_DISCO) es_escreve(self->es, D_DISCO_INTERRUPCAO, 0);
+    return 1;
+  }
 
   // atualiza as métricas do SO
   so_update_metrics(self, irq);
+  so_desconta_quantum(self);
 
   // esse print polui bastante, recomendo tirar quando estiver com mais confiança
   //console_printf("SO: recebi IRQ %d (%s)", irq, irq_nome(irq));
@@ -286,8 +780,18 @@ static int so_trata_interrupcao(void *argC, int reg_A)
   // salva o estado da cpu no descritor do processo que foi interrompido
   so_salva_estado_da_cpu(self);
 
+  // o processo que estava executando foi morto por outra CPU; a interrupção
+  //   causada por ele (chamada de sistema ou erro) não é mais atendida
+  bool atende = true;
+  if (self->cpu_atual->mata_corrente)
+  {
+    self->cpu_atual->mata_corrente = false;
+    so_mata_proc(self, self->current_process);
+    atende = irq != IRQ_SISTEMA && irq != IRQ_ERR_CPU;
+  }
+
   // faz o atendimento da interrupção
-  so_trata_irq(self, irq);
+  if (atende) so_trata_irq(self, irq);
 
   // faz o processamento independente da interrupção
   so_trata_pendencias(self);
@@ -299,13 +803,23 @@ static int so_trata_interrupcao(void *argC, int reg_A)
   if (!is_any_proc_alive(self))
   {
     so_display_pagefaults_count(self);
+    so_show_metrics(self);
     return so_suicide(self);
   }
 
   else
   {
+    // liga ou desliga o timer, de acordo com o que ficou para executar
+    so_programa_relogio(self);
+
     // recupera o estado do processo escolhido
-    return so_despacha(self);
+    int ret = so_despacha(self);
+    if (ret != 0)
+    {
+      // a CPU vai parar até a próxima interrupção
+      self->idle_since = self->latest_clock;
+    }
+    return ret;
   }
   
 }
@@ -314,7 +828,7 @@ static void so_salva_estado_da_cpu(so_t *self)
 {
   // t1: salva os registradores que compõem o estado da cpu no descritor do
   //   processo corrente. os valores dos registradores foram colocados pela
-  //   CPU na memória, nos endereços IRQ_END_*
+  //   CPU na memória, nos endereços IRQ_END_* da sua área
   // se não houver processo corrente, não faz nada
 
   if (self->current_process == NULL)
@@ -322,12 +836,13 @@ static void so_salva_estado_da_cpu(so_t *self)
     return;
   }
 
+  int area = self->cpu_atual->area_irq;
   int tmp_A, tmp_X, tmp_PC, tmp_complemento, tmp_erro;
-  mem_le(self->mem, IRQ_END_A, &tmp_A);
-  mem_le(self->mem, IRQ_END_X, &tmp_X);
-  mem_le(self->mem, IRQ_END_PC, &tmp_PC);
-  mem_le(self->mem, IRQ_END_complemento, &tmp_complemento);
-  mem_le(self->mem, IRQ_END_erro, &tmp_erro);
+  mem_le(self->mem, area + IRQ_END_A, &tmp_A);
+  mem_le(self->mem, area + IRQ_END_X, &tmp_X);
+  mem_le(self->mem, area + IRQ_END_PC, &tmp_PC);
+  mem_le(self->mem, area + IRQ_END_complemento, &tmp_complemento);
+  mem_le(self->mem, area + IRQ_END_erro, &tmp_erro);
 
   proc_set_A(self->current_process, tmp_A);
   proc_set_X(self->current_process, tmp_X);
@@ -338,6 +853,79 @@ static void so_salva_estado_da_cpu(so_t *self)
 
 int device_calc(int device, int type);
 
+// nível da fila de prontos onde o processo deve ser colocado
+static int so_nivel_na_fila(so_t *self, process_t *proc)
+{
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE3)
+  {
+    return proc_get_sched_level(proc);
+  }
+
+  if (SCHEDULER_TYPE != SCHEDULER_TYPE2)
+  {
+    return 0;
+  }
+
+  // a prioridade fica entre 0 (mais prioritário) e 1
+  int nivel = (int)(proc_get_priority(proc) * RUNQUEUE_LEVELS);
+  if (nivel >= RUNQUEUE_LEVELS) nivel = RUNQUEUE_LEVELS - 1;
+  return nivel;
+}
+
+// fila de prontos onde está (ou vai ficar) um processo: a da CPU onde ele
+// executou por último
+static runqueue_t *so_fila_de_prontos(so_t *self, process_t *proc)
+{
+  return self->cpus[proc_get_cpu(proc)].queue;
+}
+
+// coloca o processo na fila de prontos da sua CPU e, no escalonador justo, na
+//   fila por tempo virtual dela
+static void so_poe_nos_prontos(so_t *self, process_t *proc)
+{
+  runqueue_push(so_fila_de_prontos(self, proc), proc, so_nivel_na_fila(self, proc));
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE4)
+  {
+    vrqueue_push(self->cpus[proc_get_cpu(proc)].vr_queue, proc);
+  }
+}
+
+// retira o processo da fila de prontos da sua CPU (e da fila por tempo virtual)
+static void so_tira_dos_prontos(so_t *self, process_t *proc)
+{
+  runqueue_remove(so_fila_de_prontos(self, proc), proc);
+  vrqueue_remove(self->cpus[proc_get_cpu(proc)].vr_queue, proc);
+}
+
+// fila de espera onde está (ou vai ficar) um processo bloqueado, de acordo
+// com o tipo e a informação do bloqueio
+static runqueue_t *so_fila_de_espera(so_t *self, process_t *proc)
+{
+  int info = proc_get_block_info(proc);
+  switch (proc_get_block_type(proc))
+  {
+    case AGUARDA_ENTRADA:
+      return self->wait_teclado[info / 4];
+
+    case AGUARDA_SAIDA:
+      return self->wait_tela[info / 4];
+
+    case AGUARDA_PROC:
+      if (self->wait_proc[info] == NULL)
+      {
+        self->wait_proc[info] = runqueue_create(1);
+      }
+      return self->wait_proc[info];
+
+    case AGUARDA_DISCO:
+      // sem slot, o processo espera um quadro, não uma leitura
+      return info == -1 ? self->wait_quadro : self->wait_disco;
+
+    default:
+      return NULL;
+  }
+}
+
 static void so_bloqueia_proc(so_t *self, process_t* proc, int block_type, int block_info)
 {
   // console_printf("SO: bloqueei um processo, sua id era %d com causa %d", proc_get_ID(proc), block_type);
@@ -345,8 +933,16 @@ static void so_bloqueia_proc(so_t *self, process_t* proc, int block_type, int bl
   proc_set_block_type(proc, block_type);
   proc_set_block_info(proc, block_info);
 
-  void *v;
-  self->queue = list_pop(self->queue, &v);
+  // no MLFQ, quem bloqueia esperando um terminal sobe um nível
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE3 && proc_get_sched_level(proc) > 0
+      && (block_type == AGUARDA_ENTRADA || block_type == AGUARDA_SAIDA))
+  {
+    proc_set_sched_level(proc, proc_get_sched_level(proc) - 1);
+    self->metrics.mlfq_promotions++;
+  }
+
+  so_tira_dos_prontos(self, proc);
+  runqueue_push(so_fila_de_espera(self, proc), proc, 0);
   
   if (self->current_process != NULL)
   {
@@ -357,54 +953,258 @@ static void so_bloqueia_proc(so_t *self, process_t* proc, int block_type, int bl
 static void so_desbloqueia_proc(so_t *self, process_t* proc)
 {
   // console_printf("SO: desbloqueei um processo, sua id era %d", proc_get_ID(proc));
+  runqueue_remove(so_fila_de_espera(self, proc), proc);
   proc_set_state(proc, PROC_PRONTO);
   proc_set_block_type(proc, AGUARDA_NADA);
   proc_set_block_info(proc, NULL_ID);
 
-  self->queue = list_append(self->queue, proc);
+  // o tempo virtual não andou enquanto estava bloqueado; quem dormiu muito
+  //   não pode ficar tão atrás que monopolize a CPU até alcançar os outros
+  long minimo = self->cpus[proc_get_cpu(proc)].min_vruntime - CFS_CREDITO_ACORDAR;
+  if (proc_get_vruntime(proc) < minimo)
+  {
+    proc_set_vruntime(proc, minimo);
+  }
+
+  so_poe_nos_prontos(self, proc);
+}
+
+// E/S em bloco (SO_LE_BLOCO e SO_ESCR_BLOCO)
+// os caracteres passam pelo buffer de E/S do processo (proc_io_t); a cópia de
+// ou para a memória do processo é feita de uma vez, e a transferência com o
+// terminal é feita à medida que ele estiver pronto
+
+// acessa a memória de um processo qualquer (não necessariamente o que está
+// na MMU), traduzindo com a tabela de páginas dele; se a página não está na
+// memória principal, acessa a cópia dela no disco
+static err_t so_acessa_mem_do_processo(so_t *self, process_t *proc, int end_virt,
+                                       int *pvalor, bool escrita)
+{
+  // só as páginas do programa existem (todas têm slot)
+  if (end_virt < 0 || proc_get_swap_slot(proc, end_virt / TAM_PAGINA) == -1)
+  {
+    return ERR_END_INV;
+  }
+
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  int pagina = end_virt / TAM_PAGINA;
+  int quadro;
+  if (escrita && !so_pagina_gravavel(self, proc, pagina))
+  {
+    // como faria a MMU: a página compartilhada não pode ser alterada, e
+    //   não teve quadro para a cópia
+    return ERR_OCUP;
+  }
+
+  if (tabela != NULL && tabpag_traduz(tabela, pagina, &quadro) == ERR_OK)
+  {
+    int end_fis = quadro * TAM_PAGINA + end_virt % TAM_PAGINA;
+    tabpag_marca_bit_acesso(tabela, pagina, escrita);
+    if (escrita) return mem_escreve(self->mem, end_fis, *pvalor);
+    return mem_le(self->mem, end_fis, pvalor);
+  }
+
+  int end_disco = so_end_disco(self, proc, end_virt, escrita);
+  if (escrita) return disco_escreve(self->disk, end_disco, *pvalor);
+  return disco_le(self->disk, end_disco, pvalor);
+}
+
+// lê o descritor apontado pelo X do processo: endereço e número de caracteres
+// limita o número ao tamanho do buffer; retorna false se o descritor é inválido
+static bool so_le_descritor_bloco(so_t *self, process_t *proc, int *pend, int *ptam)
+{
+  int desc = proc_get_X(proc);
+  if (so_acessa_mem_do_processo(self, proc, desc, pend, false) != ERR_OK
+      || so_acessa_mem_do_processo(self, proc, desc + 1, ptam, false) != ERR_OK
+      || *ptam < 0)
+  {
+    return false;
+  }
+
+  if (*ptam > PROC_TAM_BUF_ES) *ptam = PROC_TAM_BUF_ES;
+  return true;
 }
 
-static void so_trata_pendencia_leitura(so_t *self, process_t* proc)
+// escreve no terminal do processo o que puder do buffer de E/S
+// retorna true se escreveu tudo (e coloca em A quanto escreveu)
+static bool so_escreve_bloco(so_t *self, process_t *proc)
 {
+  proc_io_t *io = proc_get_io_ptr(proc);
+  int base_device = proc_get_device(proc);
+
+  while (io->pos < io->tam)
+  {
+    int estado;
+    if (es_le(self->es, device_calc(base_device, TELA_OK), &estado) != ERR_OK) {
+      console_printf("SO: problema no acesso ao estado da tela");
+      self->erro_interno = true;
+      return false;
+    }
+
+    if (estado == 0)
+    {
+      return false;
+    }
+
+    if (es_escreve(self->es, device_calc(base_device, TELA), io->buf[io->pos]) != ERR_OK) {
+      console_printf("SO: problema no acesso à tela");
+      self->erro_interno = true;
+      return false;
+    }
+    io->pos++;
+  }
+
+  proc_set_A(proc, io->tam);
+  io->tam = 0;
+  return true;
+}
+
+// separa as páginas compartilhadas onde a leitura em bloco vai escrever, antes
+//   de ler qualquer caractere do terminal (que não poderia ser devolvido)
+// retorna false se alguma não pôde ser separada por falta de quadro
+static bool so_destino_gravavel(so_t *self, process_t *proc)
+{
+  proc_io_t *io = proc_get_io_ptr(proc);
+  if (io->end_destino < 0) return true;  // o erro aparece na cópia
+
+  int ultima = (io->end_destino + io->tam - 1) / TAM_PAGINA;
+  for (int pagina = io->end_destino / TAM_PAGINA; pagina <= ultima; pagina++)
+  {
+    if (!so_pagina_gravavel(self, proc, pagina)) return false;
+  }
+  return true;
+}
+
+// a chamada de sistema do processo não pode ser atendida agora porque falta
+//   quadro: o processo espera alguma leitura do disco terminar (wait_quadro),
+//   como na falta de página, e volta o PC para o CHAMAS, para repetir a
+//   chamada (A e X ainda têm os argumentos)
+static void so_repete_chamada_sem_quadro(so_t *self, process_t *proc)
+{
+  proc_set_PC(proc, proc_get_PC(proc) - 1);
+  so_bloqueia_proc(self, proc, AGUARDA_DISCO, -1);
+}
+
+// lê do terminal do processo os caracteres disponíveis, até o número pedido,
+// e copia para a memória do processo
+// retorna false, sem ler nada, se não tem caractere disponível
+static bool so_le_bloco(so_t *self, process_t *proc)
+{
+  proc_io_t *io = proc_get_io_ptr(proc);
+  int base_device = proc_get_device(proc);
+
+  int lidos = 0;
+  while (lidos < io->tam)
+  {
+    int estado;
+    if (es_le(self->es, device_calc(base_device, TECLADO_OK), &estado) != ERR_OK) {
+      console_printf("SO: problema no acesso ao estado do teclado");
+      self->erro_interno = true;
+      return false;
+    }
+
+    if (estado == 0)
+    {
+      break;
+    }
+
+    if (es_le(self->es, device_calc(base_device, TECLADO), &io->buf[lidos]) != ERR_OK) {
+      console_printf("SO: problema no acesso ao teclado");
+      self->erro_interno = true;
+      return false;
+    }
+    lidos++;
+  }
+
+  if (lidos == 0 && io->tam > 0)
+  {
+    return false;
+  }
+
+  int resultado = lidos;
+  for (int i = 0; i < lidos; i++)
+  {
+    if (so_acessa_mem_do_processo(self, proc, io->end_destino + i, &io->buf[i], true) != ERR_OK)
+    {
+      resultado = -1;
+      break;
+    }
+  }
+
+  proc_set_A(proc, resultado);
+  io->tam = 0;
+  return true;
+}
+
+// as funções de pendência de E/S retornam true se o processo foi desbloqueado
+
+static bool so_trata_pendencia_leitura(so_t *self, process_t* proc)
+{
+  // leitura em bloco
+  if (proc_get_io_ptr(proc)->tam > 0)
+  {
+    // a página de destino pode ter voltado a ser compartilhada enquanto o
+    //   processo esperava
+    if (!so_destino_gravavel(self, proc))
+    {
+      runqueue_remove(so_fila_de_espera(self, proc), proc);
+      so_repete_chamada_sem_quadro(self, proc);
+      return true;
+    }
+
+    if (!so_le_bloco(self, proc)) return false;
+    so_desbloqueia_proc(self, proc);
+    return true;
+  }
+
   int base_device = proc_get_device(proc);
 
   int estado;
   if (es_le(self->es, device_calc(base_device, TECLADO_OK), &estado) != ERR_OK) {
     console_printf("SO: problema no acesso ao estado do teclado");
     self->erro_interno = true;
-    return;
+    return false;
   }
 
   if (estado == 0)
   {
-    return;
+    return false;
   }
 
   int dado;
   if (es_le(self->es, device_calc(base_device, TECLADO), &dado) != ERR_OK) {
     console_printf("SO: problema no acesso ao teclado");
     self->erro_interno = true;
-    return;
+    return false;
   }
   
   proc_set_A(proc, dado);
   so_desbloqueia_proc(self, proc);
+  return true;
 }
 
-static void so_trata_pendencia_escrita(so_t *self, process_t* proc)
+static bool so_trata_pendencia_escrita(so_t *self, process_t* proc)
 {
+  // escrita em bloco
+  if (proc_get_io_ptr(proc)->tam > 0)
+  {
+    if (!so_escreve_bloco(self, proc)) return false;
+    so_desbloqueia_proc(self, proc);
+    return true;
+  }
+
   int base_device = proc_get_device(proc);
 
   int estado;
   if (es_le(self->es, device_calc(base_device, TELA_OK), &estado) != ERR_OK) {
     console_printf("SO: problema no acesso ao estado da tela");
     self->erro_interno = true;
-    return;
+    return false;
   }
 
   if (estado == 0)
   {
-    return;
+    return false;
   }
 
 
@@ -412,36 +1212,26 @@ static void so_trata_pendencia_escrita(so_t *self, process_t* proc)
   if (es_escreve(self->es, device_calc(base_device, TELA), dado) != ERR_OK) {
     console_printf("SO: problema no acesso à tela");
     self->erro_interno = true;
-    return;
+    return false;
   }
   proc_set_A(proc, 0);
   so_desbloqueia_proc(self, proc);
+  return true;
 }
 
-static void so_trata_pendencia_espera(so_t *self, process_t* proc)
+// desbloqueia todos os processos que esperam o fim do processo 'pid'
+static void so_trata_pendencia_espera(so_t *self, int pid)
 {
-  int awaiting_proc = proc_get_block_info(proc);
-  exec_state_t state = proc_get_state(self->process_table[awaiting_proc]);
-
-  if(state == PROC_MORTO)
-  {
-    so_desbloqueia_proc(self, proc);
-  }
-}
+  runqueue_t *fila = self->wait_proc[pid];
+  if (fila == NULL) return;
 
-static void so_trata_pendencia_disco(so_t *self, process_t* proc)
-{
-  if(proc_get_block_info(proc) == 0)
+  process_t *proc;
+  while ((proc = runqueue_peek(fila)) != NULL)
   {
-    proc_set_block_info(proc, AGUARDA_NADA);
     so_desbloqueia_proc(self, proc);
-    return;
   }
-
-  proc_set_block_info(proc, proc_get_block_info(proc)-1);
 }
 
-
 static void so_trata_pendencias(so_t *self)
 {
   // t1: realiza ações que não são diretamente ligadas com a interrupção que
@@ -450,38 +1240,102 @@ static void so_trata_pendencias(so_t *self)
   // - desbloqueio de processos
   // - contabilidades
 
-  for (int i = 1; i < self->process_counter; i++)
+  // a E/S nos terminais é feita quando eles interrompem (so_trata_irq_teclado
+  // e so_trata_irq_tela), a espera pelo disco termina quando ele interrompe
+  // (so_trata_irq_disco), e a espera por processos é resolvida na morte do
+  // processo esperado
+}
+
+// retorna a CPU (que não é a em atendimento) onde o processo está executando,
+//   ou NULL se não está executando em outra
+static so_cpu_t *so_cpu_executando(so_t *self, process_t *proc)
+{
+  for (int i = 0; i < self->n_cpus; i++)
   {
-    process_t *analyzed = self->process_table[i];
-    if (analyzed != NULL && proc_get_state(analyzed) == PROC_BLOQUEADO)
+    so_cpu_t *cpu = &self->cpus[i];
+    if (cpu != self->cpu_atual && cpu->current_process == proc)
     {
-      int block_type = proc_get_block_type(analyzed);
+      return cpu;
+    }
+  }
+  return NULL;
+}
 
-      switch (block_type)
-      {
-        case AGUARDA_ENTRADA:
-          so_trata_pendencia_leitura(self, analyzed);
-          break;
-        
-        case AGUARDA_SAIDA:
-          so_trata_pendencia_escrita(self, analyzed);
-          break;
+// número de processos na fila de prontos da CPU esperando por ela (sem contar
+//   o que ela está executando)
+static int so_processos_esperando(so_t *self, so_cpu_t *cpu)
+{
+  process_t *corrente = cpu == self->cpu_atual ? self->current_process
+                                               : cpu->current_process;
+  int esperando = runqueue_size(cpu->queue);
+  if (corrente != NULL && runqueue_contains(corrente))
+  {
+    esperando--;
+  }
+  return esperando;
+}
 
-        case AGUARDA_PROC:
-          so_trata_pendencia_espera(self, analyzed);
-          break;
+// passa o processo para a fila de prontos da CPU em atendimento
+static void so_migra_proc(so_t *self, process_t *proc)
+{
+  if (proc_get_metrics_ptr(proc)->executing_count > 0)
+  {
+    self->metrics.migrations++;
+  }
+  so_tira_dos_prontos(self, proc);
 
-        case AGUARDA_DISCO:
-          so_trata_pendencia_disco(self, analyzed);
-          break;
-        
-        default:
-          break;
-      }
+  // o tempo virtual é relativo ao da CPU: mantém a distância para o menor
+  so_cpu_t *origem = &self->cpus[proc_get_cpu(proc)];
+  proc_set_vruntime(proc, proc_get_vruntime(proc) - origem->min_vruntime
+                          + self->cpu_atual->min_vruntime);
+
+  proc_set_cpu(proc, self->cpu_atual->id);
+  so_poe_nos_prontos(self, proc);
+}
+
+// roubo de trabalho: a CPU em atendimento, sem nada na sua fila, pega um
+//   processo da CPU que tem mais processos esperando (sem contar o que ela
+//   está executando), do fim da fila: o último que seria escolhido lá
+// retorna o processo roubado, ou NULL se nenhuma CPU tem processo esperando
+static process_t *so_rouba_proc(so_t *self)
+{
+  so_cpu_t *vitima = NULL;
+  int mais_esperando = 0;
+  for (int i = 0; i < self->n_cpus; i++)
+  {
+    so_cpu_t *cpu = &self->cpus[i];
+    if (cpu == self->cpu_atual) continue;
+
+    int esperando = so_processos_esperando(self, cpu);
+    if (esperando > mais_esperando)
+    {
+      vitima = cpu;
+      mais_esperando = esperando;
     }
   }
-  
+  if (vitima == NULL) return NULL;
+
+  process_t *proc = runqueue_peek_last(vitima->queue);
+  if (proc == vitima->current_process)
+  {
+    proc = runqueue_prev(vitima->queue, proc);
+  }
+  so_migra_proc(self, proc);
+  self->metrics.steals++;
+  self->cpu_atual->steals++;
+  return proc;
+}
 
+// o primeiro processo da fila de prontos da CPU em atendimento; se a fila
+//   está vazia, em vez de parar a CPU tenta roubar um processo de outra
+static process_t *so_primeiro_da_fila(so_t *self)
+{
+  process_t *proc = runqueue_peek(self->queue);
+  if (proc == NULL && self->n_cpus > 1)
+  {
+    proc = so_rouba_proc(self);
+  }
+  return proc;
 }
 
 static void scheduler_dumb_type0(so_t *self)
@@ -512,67 +1366,172 @@ static void round_robin_type1(so_t *self)
 {
   if(self->quantum == 0)
   {
-    void *timed_out;
+    process_t *timed_out = runqueue_pop(self->queue);
 
-    self->queue = list_pop(self->queue, &(timed_out));
-    self->queue = list_append(self->queue, timed_out);
-
-    if (timed_out	!= NULL)
+    if (timed_out != NULL)
+    {
+      runqueue_push(self->queue, timed_out, 0);
       proc_increment_preemption(timed_out);
+    }
   }
 
-  process_t *chosen_process = list_get(self->queue, 0);
-
-  if(chosen_process == self->current_process)
-  {
-    self->quantum--;
-    self->current_process = chosen_process;
-    return;
-  }
+  process_t *chosen_process = so_primeiro_da_fila(self);
 
-  else
+  if(chosen_process != self->current_process || self->quantum == 0)
   {
     self->quantum = DEFAULT_QUANTUM;
-    self->current_process = chosen_process;
   }
-
+  self->current_process = chosen_process;
 }
 
 static void round_robin_type2(so_t *self)
 {
   if(self->quantum == 0)
   {
-    self->quantum = DEFAULT_QUANTUM;
+    // a prioridade é calculada com o quantum que sobrou (nada), antes de
+    //   renovar o quantum: quem esgota o quantum fica menos prioritário
     if (self->current_process != NULL)
     {
       proc_calc_priority(self->current_process, self->quantum, DEFAULT_QUANTUM);
       proc_increment_preemption(self->current_process);
+
+      // vai para o final do nível da nova prioridade (se ainda está na fila
+      // de prontos, e não bloqueado numa fila de espera)
+      if (proc_get_state(self->current_process) == PROC_EXECUTANDO)
+      {
+        runqueue_remove(self->queue, self->current_process);
+        runqueue_push(self->queue, self->current_process, so_nivel_na_fila(self, self->current_process));
+      }
     }
+    self->quantum = DEFAULT_QUANTUM;
   }
 
-  float min_priority = INFINITY;
-  process_t *chosen_process = NULL;
+  // o primeiro do nível mais prioritário (o processo em execução também está na fila)
+  process_t *chosen_process = so_primeiro_da_fila(self);
 
+  if (self->current_process != chosen_process)
+  {
+    self->quantum = DEFAULT_QUANTUM;
+  }
+  
+  self->current_process = chosen_process;  
+}
+
+// escalonador com filas de múltiplos níveis e realimentação (MLFQ)
+// o processo que esgota o quantum do seu nível desce um nível, onde o quantum
+//   é maior; o que bloqueia esperando um terminal sobe um (so_bloqueia_proc);
+//   de tempos em tempos todos voltam para o nível 0 (so_mlfq_impulso), para
+//   que os dos níveis de baixo não fiquem sem executar
+// o escolhido é o primeiro do nível mais prioritário não vazio da fila de
+//   prontos, e um processo que fica pronto num nível acima tira o corrente da
+//   CPU
+static void mlfq_type3(so_t *self)
+{
+  process_t *atual = self->current_process;
+  if (self->quantum == 0 && atual != NULL && proc_get_state(atual) == PROC_EXECUTANDO)
+  {
+    proc_increment_preemption(atual);
+    int nivel = proc_get_sched_level(atual);
+    if (nivel < MLFQ_NIVEIS - 1)
+    {
+      proc_set_sched_level(atual, nivel + 1);
+      self->metrics.mlfq_demotions++;
+    }
+
+    // vai para o final do seu (novo) nível
+    runqueue_remove(self->queue, atual);
+    runqueue_push(self->queue, atual, so_nivel_na_fila(self, atual));
+  }
+
+  process_t *chosen_process = so_primeiro_da_fila(self);
+
+  if (chosen_process != NULL && (chosen_process != atual || self->quantum == 0))
+  {
+    self->quantum = MLFQ_QUANTUM(proc_get_sched_level(chosen_process));
+  }
+
+  self->current_process = chosen_process;
+}
+
+// impulso do MLFQ: coloca todos os processos no nível 0; os que estão na fila
+//   de prontos vão para o final dele, os bloqueados voltam nele
+static void so_mlfq_impulso(so_t *self)
+{
   for (int i = 1; i < self->process_counter; i++)
   {
-    process_t *analyzed = self->process_table[i];   
-    if (analyzed != NULL && (proc_get_state(analyzed) == PROC_PRONTO || proc_get_state(analyzed) == PROC_EXECUTANDO))
+    process_t *proc = self->process_table[i];
+    if (proc == NULL || proc_get_state(proc) == PROC_MORTO
+        || proc_get_sched_level(proc) == 0)
     {
-      double cur_priority = proc_get_priority(analyzed);
-      if (cur_priority < min_priority)
-      {
-        min_priority = cur_priority;
-        chosen_process = analyzed;
-      }
+      continue;
+    }
+
+    proc_set_sched_level(proc, 0);
+    if (proc_get_state(proc) != PROC_BLOQUEADO)
+    {
+      runqueue_t *fila = so_fila_de_prontos(self, proc);
+      runqueue_remove(fila, proc);
+      runqueue_push(fila, proc, 0);
+    }
+  }
+  self->metrics.mlfq_boosts++;
+}
+
+// escalonador justo (CFS): o escolhido é o de menor tempo virtual entre os
+//   prontos da CPU, que ficam numa fila ordenada por ele (vrqueue); o corrente
+//   fica fora dessa fila enquanto executa, porque o tempo virtual dele muda
+//   (so_update_metrics), e volta para ela quando perde a CPU
+static void cfs_type4(so_t *self)
+{
+  so_cpu_t *cpu = self->cpu_atual;
+  process_t *atual = self->current_process;
+  bool executando = atual != NULL && proc_get_state(atual) == PROC_EXECUTANDO;
+  process_t *primeiro = vrqueue_peek(cpu->vr_queue);
+
+  if (executando)
+  {
+    // continua enquanto tem quantum e não passou muito à frente de quem espera
+    bool a_frente = primeiro != NULL
+      && proc_get_vruntime(atual) > proc_get_vruntime(primeiro) + CFS_GRANULARIDADE;
+    if (primeiro == NULL || (self->quantum > 0 && !a_frente))
+    {
+      if (self->quantum == 0) self->quantum = DEFAULT_QUANTUM;
+    }
+
+    else
+    {
+      if (self->quantum > 0) self->metrics.cfs_preemptions++;
+      proc_increment_preemption(atual);
+      vrqueue_push(cpu->vr_queue, atual);
+      executando = false;
     }
   }
 
-  if (self->current_process == chosen_process)
+  if (!executando)
   {
-    self->quantum--;
+    // sem ninguém pronto aqui, tenta roubar de outra CPU
+    if (vrqueue_size(cpu->vr_queue) == 0 && self->n_cpus > 1)
+    {
+      so_rouba_proc(self);
+    }
+
+    atual = vrqueue_pop(cpu->vr_queue);
+    self->current_process = atual;
+    self->quantum = DEFAULT_QUANTUM;
+  }
+
+  // o menor tempo virtual da CPU acompanha o do corrente e o do primeiro da
+  //   fila, mas nunca volta
+  long minimo = atual != NULL ? proc_get_vruntime(atual) : cpu->min_vruntime;
+  primeiro = vrqueue_peek(cpu->vr_queue);
+  if (primeiro != NULL && proc_get_vruntime(primeiro) < minimo)
+  {
+    minimo = proc_get_vruntime(primeiro);
+  }
+  if (minimo > cpu->min_vruntime)
+  {
+    cpu->min_vruntime = minimo;
   }
-  
-  self->current_process = chosen_process;  
 }
 
 int so_suicide(so_t *self)
@@ -584,6 +1543,7 @@ int so_suicide(so_t *self)
     console_printf("SO: não consigo parar VOU DOMINAR O MUNDO EXECUÇÃO ETERNA");
     self->erro_interno = true;
   }
+  self->desligado = true;
   console_printf("--------------------------------------------------");
   console_printf("--------------------------------------------------");
   console_printf("--------------------------------------------------");
@@ -636,6 +1596,22 @@ static void so_escalona(so_t *self)
     case SCHEDULER_TYPE2:
       round_robin_type2(self);
       break;
+
+    case SCHEDULER_TYPE3:
+      mlfq_type3(self);
+      break;
+
+    case SCHEDULER_TYPE4:
+      cfs_type4(self);
+      break;
+  }
+
+  // o tipo 0 escolhe entre todos os processos, e o escolhido pode estar na
+  //   fila de outra CPU
+  if (self->current_process != NULL
+      && proc_get_cpu(self->current_process) != self->cpu_atual->id)
+  {
+    so_migra_proc(self, self->current_process);
   }
  
   if (irq_causer != self->current_process)
@@ -654,6 +1630,130 @@ static void so_escalona(so_t *self)
   
 }
 
+// quantas instruções a CPU deixa o processo corrente executar antes de
+//   precisar do SO para escalonar: o resto do quantum (menos o que ela já
+//   executou e ainda não foi descontado, se não é a CPU em atendimento) ou, no
+//   escalonador justo, até ele passar CFS_GRANULARIDADE à frente do primeiro
+//   da fila; 0 se ninguém espera por ela, e o corrente pode continuar
+static int so_instrucoes_ate_preempcao(so_t *self, so_cpu_t *cpu)
+{
+  process_t *corrente = cpu == self->cpu_atual ? self->current_process
+                                               : cpu->current_process;
+  int quantum = cpu == self->cpu_atual ? self->quantum : cpu->quantum;
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE0 || corrente == NULL
+      || so_processos_esperando(self, cpu) == 0)
+  {
+    return 0;
+  }
+
+  int faltam = quantum - (cpu_instrucoes_executadas(cpu->cpu) - cpu->instrucoes_cobradas);
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE4)
+  {
+    process_t *primeiro = vrqueue_peek(cpu->vr_queue);
+    if (primeiro != NULL)
+    {
+      int ate_passar = proc_instrucoes_ate_vruntime(corrente,
+                         proc_get_vruntime(primeiro) + CFS_GRANULARIDADE);
+      if (ate_passar < faltam) faltam = ate_passar;
+    }
+  }
+  return faltam > 0 ? faltam : 1;
+}
+
+// quantas instruções faltam para a próxima manutenção periódica do relógio
+//   (so_trata_irq_relogio), ou 0 se ela não tem o que fazer: ela é útil se os
+//   quadros são envelhecidos (AGING), o paginador tem quadros a liberar, o
+//   MLFQ tem processo esperando que um impulso pode favorecer, uma CPU parada
+//   pode roubar um processo esperando por outra, ou uma CPU ainda tem que
+//   entrar no SO para matar o seu processo corrente (mata_corrente)
+static int so_instrucoes_ate_manutencao(so_t *self)
+{
+  bool util = SWAP_ALGORITHM == AGING
+    || frame_alloc_free_count(self->frames) < PAGER_QUADROS_LIVRES;
+  bool alguem_parado = false;
+  bool alguem_esperando = false;
+  for (int i = 0; i < self->n_cpus; i++)
+  {
+    so_cpu_t *cpu = &self->cpus[i];
+    process_t *corrente = cpu == self->cpu_atual ? self->current_process
+                                                 : cpu->current_process;
+    if (cpu->mata_corrente) util = true;
+    if (corrente == NULL) alguem_parado = true;
+    if (so_processos_esperando(self, cpu) > 0) alguem_esperando = true;
+  }
+  if (alguem_esperando && (alguem_parado || SCHEDULER_TYPE == SCHEDULER_TYPE3))
+  {
+    util = true;
+  }
+  if (!util) return 0;
+
+  int faltam = self->ultima_manutencao + INTERVALO_INTERRUPCAO - self->latest_clock;
+  return faltam > 0 ? faltam : 1;
+}
+
+// retorna o mais próximo de dois prazos em instruções (0 é sem prazo)
+static int so_prazo_mais_proximo(int prazo1, int prazo2)
+{
+  if (prazo1 == 0) return prazo2;
+  if (prazo2 == 0) return prazo1;
+  return prazo1 < prazo2 ? prazo1 : prazo2;
+}
+
+// programa o timer para o próximo prazo em que o SO tem o que fazer: o fim do
+//   quantum de um processo que tem outro esperando pela sua CPU, ou a próxima
+//   manutenção periódica, o que vier primeiro; sem nenhum, o timer é desligado,
+//   e a próxima interrupção útil é a do fim de um pedido ao disco ou de um
+//   terminal (o controlador avança o tempo direto até ela)
+// o timer é reprogramado em toda entrada no SO, e os prazos são contados a
+//   partir do quanto cada um já executou, então entradas frequentes (chamadas
+//   de sistema, por exemplo) não atrasam a interrupção
+// com TIMER_DINAMICO 0, o timer é periódico: interrompe a cada
+//   INTERVALO_INTERRUPCAO, e só é programado de novo quando expira
+static void so_programa_relogio(so_t *self)
+{
+  int timer, tem_int;
+  if (es_le(self->es, D_RELOGIO_TIMER, &timer) != ERR_OK
+      || es_le(self->es, D_RELOGIO_INTERRUPCAO, &tem_int) != ERR_OK) {
+    console_printf("SO: problema no acesso ao timer");
+    self->erro_interno = true;
+    return;
+  }
+
+  // o timer expirou e a interrupção ainda não foi atendida; ele é programado
+  //   de novo no atendimento dela
+  if (tem_int != 0) return;
+
+  int prazo;
+  if (!TIMER_DINAMICO)
+  {
+    if (timer != 0) return;
+    prazo = INTERVALO_INTERRUPCAO;
+  }
+  else
+  {
+    prazo = so_instrucoes_ate_manutencao(self);
+    for (int i = 0; i < self->n_cpus; i++)
+    {
+      prazo = so_prazo_mais_proximo(prazo, so_instrucoes_ate_preempcao(self, &self->cpus[i]));
+    }
+  }
+
+  if (prazo != 0 && self->timer_off_since != -1)
+  {
+    self->metrics.timer_off_time += self->latest_clock - self->timer_off_since;
+    self->timer_off_since = -1;
+  }
+  else if (prazo == 0 && self->timer_off_since == -1)
+  {
+    self->timer_off_since = self->latest_clock;
+  }
+
+  if (prazo != timer && es_escreve(self->es, D_RELOGIO_TIMER, prazo) != ERR_OK) {
+    console_printf("SO: problema na programação do timer");
+    self->erro_interno = true;
+  }
+}
+
 static int so_despacha(so_t *self)
 {
   // t1: se houver processo corrente, coloca o estado desse processo onde ele
@@ -668,39 +1768,61 @@ static int so_despacha(so_t *self)
   complemento = proc_get_complemento(self->current_process);
   tabpag_t *tab_pag = proc_get_tab_pag(self->current_process);
 
-  mem_escreve(self->mem, IRQ_END_A, a);
-  mem_escreve(self->mem, IRQ_END_X, x);
-  mem_escreve(self->mem, IRQ_END_PC, pc);
-  mem_escreve(self->mem, IRQ_END_complemento, complemento);
-  mem_escreve(self->mem, IRQ_END_erro, ERR_OK);
+  int area = self->cpu_atual->area_irq;
+  mem_escreve(self->mem, area + IRQ_END_A, a);
+  mem_escreve(self->mem, area + IRQ_END_X, x);
+  mem_escreve(self->mem, area + IRQ_END_PC, pc);
+  mem_escreve(self->mem, area + IRQ_END_complemento, complemento);
+  mem_escreve(self->mem, area + IRQ_END_erro, ERR_OK);
+  // se o processo executou em outra CPU, a MMU dela esquece as traduções
+  //   da tabela (ver tabpag_define_f_sincroniza)
   mmu_define_tabpag(self->mmu, tab_pag);
 
   return 0;
 }
 
-process_t *so_novo_proc(so_t *self, char* origin)
+// coloca o processo (criado com o próximo pid) na tabela de processos e na
+//   fila de prontos
+static void so_registra_proc(so_t *self, process_t *proc)
 {
-  process_t *proc = proc_create(self->process_counter);
-  int ender = so_carrega_programa(self, proc, origin);
-  proc_set_PC(proc, ender);
-
-  if (self->process_counter == MAX_PROC)
+  if (self->process_counter == self->process_slots)
   {
+    int old_slots = self->process_slots;
     self->process_slots *= 2;
     self->process_table = realloc(self->process_table, sizeof(process_t *) * self->process_slots);
+    self->wait_proc = realloc(self->wait_proc, sizeof(runqueue_t *) * self->process_slots);
 
-    if(self->process_table == NULL)
+    if(self->process_table == NULL || self->wait_proc == NULL)
     {
       console_printf("Erro crítico do SO\n");
       exit(-1);
     }
 
+    for (int i = old_slots; i < self->process_slots; i++)
+    {
+      self->wait_proc[i] = NULL;
+    }
   }
   
   self->process_table[self->process_counter] = proc;
   self->process_counter++;
 
-  self->queue = list_append(self->queue, proc);
+  // começa na fila da CPU que o criou, com o menor tempo virtual dela; outra
+  //   CPU sem processo pode roubá-lo
+  proc_set_cpu(proc, self->cpu_atual->id);
+  proc_set_vruntime(proc, self->cpu_atual->min_vruntime);
+  so_poe_nos_prontos(self, proc);
+}
+
+process_t *so_novo_proc(so_t *self, char* origin)
+{
+  process_t *proc = proc_create(self->process_counter);
+  int ender = so_carrega_programa(self, proc, origin);
+  proc_set_PC(proc, ender);
+  proc_set_prefetch_window(proc, PREFETCH_JANELA_INICIAL < PREFETCH_JANELA_MAX
+                                 ? PREFETCH_JANELA_INICIAL : PREFETCH_JANELA_MAX);
+
+  so_registra_proc(self, proc);
 
   return proc;
 }
@@ -712,6 +1834,10 @@ static void so_trata_irq_reset(so_t *self);
 static void so_trata_irq_chamada_sistema(so_t *self);
 static void so_trata_irq_err_cpu(so_t *self);
 static void so_trata_irq_relogio(so_t *self);
+static void so_trata_irq_teclado(so_t *self);
+static void so_trata_irq_tela(so_t *self);
+static void so_trata_irq_disco(so_t *self);
+static void so_trata_irq_ipi(so_t *self);
 static void so_trata_irq_desconhecida(so_t *self, int irq);
 
 static void so_trata_irq(so_t *self, int irq)
@@ -730,12 +1856,26 @@ static void so_trata_irq(so_t *self, int irq)
     case IRQ_RELOGIO:
       so_trata_irq_relogio(self);
       break;
+    case IRQ_TECLADO:
+      so_trata_irq_teclado(self);
+      break;
+    case IRQ_TELA:
+      so_trata_irq_tela(self);
+      break;
+    case IRQ_DISCO:
+      so_trata_irq_disco(self);
+      break;
+    case IRQ_IPI:
+      so_trata_irq_ipi(self);
+      break;
     default:
       so_trata_irq_desconhecida(self, irq);
   }
 }
 
-// interrupção gerada uma única vez, quando a CPU inicializa
+// interrupção gerada uma única vez, quando cada CPU inicializa
+// a primeira cria o init; as outras começam sem processo, e pegam um da fila
+//   de prontos no escalonamento
 static void so_trata_irq_reset(so_t *self)
 {
   // t1: deveria criar um processo para o init, e inicializar o estado do
@@ -745,79 +1885,284 @@ static void so_trata_irq_reset(so_t *self)
   //   registradores diretamente para a memória, de onde a CPU vai carregar
   //   para os seus registradores quando executar a instrução RETI
 
-  process_t *process = so_novo_proc(self, "init.maq");
-  self->current_process = process;
-  proc_set_state(process, PROC_EXECUTANDO);
+  if (self->process_counter == 1)
+  {
+    process_t *process = so_novo_proc(self, self->programa_inicial);
+    self->current_process = process;
+    proc_set_state(process, PROC_EXECUTANDO);
+    // no escalonador justo o corrente fica fora da fila por tempo virtual (o
+    //   tempo dele muda enquanto executa); nos outros ele continua na fila
+    vrqueue_remove(self->cpu_atual->vr_queue, process);
+  }
 
   // passa o processador para modo usuário
-  mem_escreve(self->mem, IRQ_END_modo, usuario);
+  mem_escreve(self->mem, self->cpu_atual->area_irq + IRQ_END_modo, usuario);
 }
 
-static bool is_any_block_free(so_t *self)
+// quadros da memória física
+
+// coloca o quadro na lista de quadros do processo
+static void so_liga_quadro(so_t *self, int quadro, process_t *proc)
 {
-  for (size_t i = 0; i < self->num_physical_pages; i++)
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  int primeiro = proc_get_frame_list(proc);
+  bloco->prev_owned = -1;
+  bloco->next_owned = primeiro;
+  if (primeiro != -1)
   {
-    if (!self->mem_tracker[i].used)
-    {
-      return true;
-    }
-    
+    self->mem_tracker[primeiro].prev_owned = quadro;
   }
+  proc_set_frame_list(proc, quadro);
 
-  return false;
+  proc_metrics_t *metrics = proc_get_metrics_ptr(proc);
+  metrics->resident_pages++;
+  if (metrics->resident_pages > metrics->max_resident_pages)
+  {
+    metrics->max_resident_pages = metrics->resident_pages;
+  }
+}
+
+// coloca a página 'pagina' do processo no quadro 'quadro' (já retirado dos
+//   livres), e o quadro na lista de quadros do processo
+static void so_ocupa_quadro(so_t *self, int quadro, process_t *proc, int pagina)
+{
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  bloco->used = true;
+  bloco->user = proc_get_ID(proc);
+  bloco->page = pagina;
+  bloco->chance = false;
+  bloco->prefetched = false;
+  bloco->refs = 1;
+  bloco->slot = -1;
+  // acabou de ser acessada (é a página que causou a falta)
+  bloco->age = 0x80;
+
+  if(es_le(self->es, D_RELOGIO_INSTRUCOES, &bloco->cicles) != ERR_OK)
+  {
+    console_printf("Erro crítico de atualização da memória");
+  }
+
+  so_liga_quadro(self, quadro, proc);
+}
+
+// tira o quadro 'quadro' da lista do processo que o ocupa
+// o quadro continua marcado como usado (é reaproveitado na substituição)
+static void so_desocupa_quadro(so_t *self, int quadro, process_t *proc)
+{
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+
+  if (bloco->prev_owned != -1)
+  {
+    self->mem_tracker[bloco->prev_owned].next_owned = bloco->next_owned;
+  }
+
+  else
+  {
+    proc_set_frame_list(proc, bloco->next_owned);
+  }
+
+  if (bloco->next_owned != -1)
+  {
+    self->mem_tracker[bloco->next_owned].prev_owned = bloco->prev_owned;
+  }
+
+  bloco->prev_owned = -1;
+  bloco->next_owned = -1;
+  proc_get_metrics_ptr(proc)->resident_pages--;
+}
+
+// quadros compartilhados
+// uma página de programa ainda não alterada (o slot dela é compartilhado com a
+//   imagem do programa) é mapeada protegida contra escrita, e o quadro onde
+//   ela está fica registrado em quadro_do_slot; outro processo que executa o
+//   mesmo programa e precisa da página mapeia o mesmo quadro, sem ler o disco
+// o quadro fica na lista do processo que o ocupou (o dono), e refs conta
+//   quantas tabelas de páginas o mapeiam; a página tem o mesmo número em todas
+// a escrita numa página protegida dá ao processo uma cópia do quadro só dele
+//   (so_quebra_compartilhamento)
+// um processo duplicado (SO_FORK) compartilha da mesma forma todas as páginas
+//   com o pai, não só as do programa (so_duplica_memoria)
+
+// retorna true se a tabela de páginas do processo mapeia o quadro
+static bool so_proc_mapeia_quadro(so_t *self, process_t *proc, int quadro)
+{
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  int mapeado;
+  return tabela != NULL
+         && tabpag_traduz(tabela, self->mem_tracker[quadro].page, &mapeado) == ERR_OK
+         && mapeado == quadro;
+}
+
+// retorna o bit de acesso da página do quadro na tabela do processo, se ela
+//   mapeia o quadro; se 'zera', zera o bit
+static bool so_bit_acesso_do_proc(so_t *self, process_t *proc, int quadro, bool zera)
+{
+  if (!so_proc_mapeia_quadro(self, proc, quadro)) return false;
+
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  int pagina = self->mem_tracker[quadro].page;
+  if (!tabpag_bit_acesso(tabela, pagina)) return false;
+
+  if (zera) tabpag_zera_bit_acesso(tabela, pagina);
+  return true;
 }
 
-static int find_free_page(so_t *self)
+// retorna o bit de acesso do quadro: se alguma tabela que o mapeia marcou
+//   acesso à página; se 'zera', zera o bit em todas
+// um quadro não compartilhado só é mapeado pelo dono, e é consultado direto
+//   na tabela dele; só os compartilhados precisam procurar nos processos
+static bool so_bit_acesso_quadro(so_t *self, int quadro, bool zera)
 {
-  for (size_t i = 0; i < self->num_physical_pages; i++)
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  if (zera)
   {
-    if (!self->mem_tracker[i].used)
+    // o acesso ainda não contado a uma página antecipada seria perdido
+    so_confere_antecipacao(self, quadro);
+  }
+
+  if (bloco->refs <= 1)
+  {
+    if (bloco->user <= 0 || bloco->user >= self->process_counter) return false;
+    return so_bit_acesso_do_proc(self, self->process_table[bloco->user], quadro, zera);
+  }
+
+  bool acessado = false;
+  for (int i = 1; i < self->process_counter; i++)
+  {
+    if (so_bit_acesso_do_proc(self, self->process_table[i], quadro, zera))
     {
-      return i;
+      acessado = true;
     }
   }
+  return acessado;
+}
+
+// tira o quadro do registro de quadros com páginas de programa (a página vai
+//   ser alterada ou sair da memória)
+static void so_esquece_slot_do_quadro(so_t *self, int quadro)
+{
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  if (bloco->slot != -1)
+  {
+    self->quadro_do_slot[bloco->slot] = -1;
+    bloco->slot = -1;
+  }
+}
 
-  return -1;
+// mapeia a página do processo no quadro (já ocupado por ela), que tem o
+//   conteúdo do slot 'slot'; se o slot é compartilhado, a página fica
+//   protegida e o quadro registrado para ser compartilhado
+static void so_mapeia_pagina(so_t *self, process_t *proc, int pagina, int quadro, int slot)
+{
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  tabpag_define_quadro(tabela, pagina, quadro);
+  if (slot != -1 && swap_refcount(self->swap, slot) > 1)
+  {
+    tabpag_protege_pagina(tabela, pagina, true);
+    self->mem_tracker[quadro].slot = slot;
+    self->quadro_do_slot[slot] = quadro;
+  }
 }
 
-static void so_trata_page_fault_espaco_encontrado(so_t *self, int end_causador)
+// se a página do processo já está num quadro, de outro processo que executa o
+//   mesmo programa, mapeia esse quadro também (protegido)
+// retorna true se mapeou
+static bool so_compartilha_quadro(so_t *self, process_t *proc, int pagina)
 {
-    int free_page = find_free_page(self);
-    
-    int end_disk_ini = proc_get_disk_address(self->current_process) + end_causador - end_causador%TAM_PAGINA;
-    int end_disk = end_disk_ini;
+  int slot = proc_get_swap_slot(proc, pagina);
+  if (slot == -1 || self->quadro_do_slot[slot] == -1)
+  {
+    return false;
+  }
 
-    int end_virt_ini = end_causador;
-    int end_virt_fim = end_virt_ini + TAM_PAGINA - 1;
+  int quadro = self->quadro_do_slot[slot];
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  tabpag_define_quadro(tabela, pagina, quadro);
+  tabpag_protege_pagina(tabela, pagina, true);
+  self->mem_tracker[quadro].refs++;
+  self->metrics.shared_maps++;
+  return true;
+}
 
-    for (int end_virt = end_virt_ini; end_virt <= end_virt_fim; end_virt++) {
-      int dado;
-      if (mem_le(self->disk, end_disk, &dado) != ERR_OK) {
-        console_printf("Erro na leitura no tratamento de page fault");
-        return;
-      }
+// o dono do quadro compartilhado vai deixar de mapeá-lo: passa o quadro para a
+//   lista de outro processo que o mapeia
+// retorna false se não achou outro processo
+static bool so_passa_quadro_adiante(so_t *self, int quadro, process_t *dono)
+{
+  for (int i = 1; i < self->process_counter; i++)
+  {
+    process_t *proc = self->process_table[i];
+    if (proc == dono || !so_proc_mapeia_quadro(self, proc, quadro)) continue;
 
-      int physical_target_address = free_page*TAM_PAGINA + (end_virt - end_virt_ini);
+    so_desocupa_quadro(self, quadro, dono);
+    so_liga_quadro(self, quadro, proc);
+    self->mem_tracker[quadro].user = proc_get_ID(proc);
+    return true;
+  }
+  return false;
+}
 
-      if (mem_escreve(self->mem, physical_target_address, dado) != ERR_OK) {
-        console_printf("Erro na escrita no tratamento de page fault");
-        return;
-      }
-      end_disk++;
-    }
+// o processo deixa de mapear o quadro compartilhado (a página não é invalidada
+//   aqui); se era o dono, o quadro passa para outro
+static void so_solta_quadro_compartilhado(so_t *self, int quadro, process_t *proc)
+{
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  if (bloco->user == proc_get_ID(proc))
+  {
+    so_passa_quadro_adiante(self, quadro, proc);
+  }
+  bloco->refs--;
+}
 
-    self->mem_tracker[free_page].used = true;
-    self->mem_tracker[free_page].user = proc_get_ID(self->current_process);
-    self->mem_tracker[free_page].page = end_causador/TAM_PAGINA;
-    self->mem_tracker[free_page].chance = false;
+// devolve ao alocador todos os quadros ocupados pelo processo
+// os quadros do processo estão na lista dele; os compartilhados continuam na
+//   memória para os outros processos que os mapeiam
+static void so_libera_quadros_do_processo(so_t *self, process_t *proc)
+{
+  // quadros compartilhados de outros donos que o processo também mapeia
+  for (int quadro = 0; quadro < self->num_physical_pages; quadro++)
+  {
+    mem_block_t *bloco = &self->mem_tracker[quadro];
+    if (bloco->used && bloco->refs > 1 && bloco->user != proc_get_ID(proc)
+        && so_proc_mapeia_quadro(self, proc, quadro))
+    {
+      bloco->refs--;
+    }
+  }
 
-    if(es_le(self->es, D_RELOGIO_INSTRUCOES, &self->mem_tracker[free_page].cicles) != ERR_OK)
+  int quadro;
+  while ((quadro = proc_get_frame_list(proc)) != -1)
+  {
+    so_encerra_antecipacao(self, quadro, false);
+    mem_block_t *bloco = &self->mem_tracker[quadro];
+    if (bloco->refs > 1 && so_passa_quadro_adiante(self, quadro, proc))
     {
-      console_printf("Erro crítico de atualização da memória");
+      bloco->refs--;
+      continue;
     }
 
-    tabpag_t *tabela = proc_get_tab_pag(self->current_process);
-    tabpag_define_quadro(tabela, end_causador/TAM_PAGINA, free_page);
+    so_desocupa_quadro(self, quadro, proc);
+    so_esquece_slot_do_quadro(self, quadro);
+    bloco->used = false;
+    frame_alloc_put(self->frames, quadro);
+  }
+}
+
+// coloca a página que causou a falta num quadro livre
+// retorna o slot do disco de onde a página foi lida, ou -1 se não leu
+static int so_trata_page_fault_espaco_encontrado(so_t *self, int end_causador)
+{
+    int free_page = frame_alloc_get(self->frames);
+
+    int slot = so_slot_disco(self, self->current_process, end_causador/TAM_PAGINA, false);
+    if (so_copia_disco_para_quadro(self, slot, free_page) != ERR_OK) {
+      console_printf("Erro na leitura no tratamento de page fault");
+      return -1;
+    }
+
+    so_ocupa_quadro(self, free_page, self->current_process, end_causador/TAM_PAGINA);
+    so_mapeia_pagina(self, self->current_process, end_causador/TAM_PAGINA, free_page, slot);
+    return slot;
 }
 
 
@@ -874,8 +2219,7 @@ static int second_chance(so_t *self)
   // loop para os sem segunda chance
   for (int i = 2; i < self->num_physical_pages; i++)
   {   
-    tabpag_t *proc_tabpag = proc_get_tab_pag(self->process_table[self->mem_tracker[i].user]);
-    if (tabpag_bit_acesso(proc_tabpag, self->mem_tracker[i].page) == 0)
+    if (!so_bit_acesso_quadro(self, i, false))
     {
       int this_cicles = cur_cicles - self->mem_tracker[i].cicles;
       process_t *user_process = self->process_table[self->mem_tracker[i].user];
@@ -891,10 +2235,8 @@ static int second_chance(so_t *self)
   {
     for (int i = 2; i < self->num_physical_pages; i++)
     {   
-      tabpag_t *proc_tabpag = proc_get_tab_pag(self->process_table[self->mem_tracker[i].user]);
-      if (tabpag_bit_acesso(proc_tabpag, self->mem_tracker[i].page) == 1)
+      if (so_bit_acesso_quadro(self, i, true))
       {
-        tabpag_zera_bit_acesso(proc_tabpag, self->mem_tracker[i].page);
         int this_cicles = cur_cicles - self->mem_tracker[i].cicles;
         process_t *user_process = self->process_table[self->mem_tracker[i].user];
         if (this_cicles > max_cycles && proc_get_block_info(user_process) != AGUARDA_DISCO)
@@ -909,6 +2251,116 @@ static int second_chance(so_t *self)
   return purged_block;
 }
 
+// relógio: o ponteiro anda circularmente pelos quadros, a partir de onde parou
+//   na escolha anterior; um quadro com o bit de acesso ligado tem o bit zerado
+//   e é pulado (segunda chance), o primeiro sem o bit é a vítima
+// quadros reservados (do SO) e de processos esperando o disco não podem ser
+//   escolhidos; se só tiver esses, retorna -1
+static int clock_replacement(so_t *self)
+{
+  int n = self->num_physical_pages;
+  int examinados = 0;
+  int escolhido = -1;
+
+  // em duas voltas todos os bits de acesso já foram zerados
+  while (examinados < 2 * n)
+  {
+    int i = self->clock_hand;
+    self->clock_hand = (i + 1) % n;
+    examinados++;
+
+    mem_block_t *bloco = &self->mem_tracker[i];
+    if (!bloco->used || bloco->user == 0)
+    {
+      continue;
+    }
+
+    process_t *user_process = self->process_table[bloco->user];
+    if (proc_get_block_type(user_process) == AGUARDA_DISCO)
+    {
+      continue;
+    }
+
+    if (so_bit_acesso_quadro(self, i, true))
+    {
+      continue;
+    }
+
+    escolhido = i;
+    break;
+  }
+
+  self->metrics.clock_selections++;
+  self->metrics.clock_scanned += examinados;
+  if (examinados > self->metrics.clock_max_scan)
+  {
+    self->metrics.clock_max_scan = examinados;
+  }
+
+  return escolhido;
+}
+
+// envelhecimento: a cada interrupção do relógio, o bit de acesso de cada página
+//   na memória entra no bit mais alto da idade do quadro, e é zerado; a vítima
+//   é o quadro de menor idade (o menos usado recentemente), e entre os de mesma
+//   idade o que está há mais tempo na memória
+static void so_envelhece_quadros(so_t *self)
+{
+  for (int i = 0; i < self->num_physical_pages; i++)
+  {
+    mem_block_t *bloco = &self->mem_tracker[i];
+    if (!bloco->used || bloco->user == 0)
+    {
+      continue;
+    }
+
+    bloco->age >>= 1;
+    if (so_bit_acesso_quadro(self, i, true))
+    {
+      bloco->age |= 0x80;
+    }
+  }
+}
+
+static int aging(so_t *self)
+{
+  int purged_block = -1;
+  int menor_idade = 0;
+
+  for (int i = 0; i < self->num_physical_pages; i++)
+  {
+    mem_block_t *bloco = &self->mem_tracker[i];
+    if (!bloco->used || bloco->user == 0)
+    {
+      continue;
+    }
+
+    process_t *user_process = self->process_table[bloco->user];
+    if (proc_get_block_type(user_process) == AGUARDA_DISCO)
+    {
+      continue;
+    }
+
+    // o bit de acesso ainda não incorporado à idade conta como o mais alto
+    int idade = bloco->age;
+    if (so_bit_acesso_quadro(self, i, false))
+    {
+      idade |= 0x100;
+    }
+
+    if (purged_block == -1
+        || idade < menor_idade
+        || (idade == menor_idade
+            && bloco->cicles < self->mem_tracker[purged_block].cicles))
+    {
+      purged_block = i;
+      menor_idade = idade;
+    }
+  }
+
+  return purged_block;
+}
+
 static int choose_purged_mem_block(so_t *self)
 {
   // retorna o índice do quadro a ser removido
@@ -922,114 +2374,584 @@ static int choose_purged_mem_block(so_t *self)
 
     case SECOND_CHANCE:
       return second_chance(self);
+
+    case CLOCK:
+      return clock_replacement(self);
+
+    case AGING:
+      return aging(self);
+  }
+
+}
+
+// pedidos ao disco
+// a controladora atende um pedido de cada vez; os outros esperam na fila do
+//   SO, e quando a controladora fica livre o escalonador do disco
+//   (DISK_SCHEDULER) escolhe qual atender, pela trilha onde o braço está:
+// - DISK_FCFS: na ordem de chegada
+// - DISK_SSTF: o de trilha mais próxima
+// - DISK_SCAN: o mais próximo no sentido em que o braço anda; quando não tem
+//   mais pedido nesse sentido, inverte (o braço não vai até a borda do disco
+//   se não tem pedido lá)
+// - DISK_C_LOOK: o mais próximo andando só para trilhas maiores; quando não
+//   tem mais, volta para o de menor trilha
+
+static int so_disco_trilha(int slot)
+{
+  return slot / DISCO_SETORES_POR_TRILHA;
+}
+
+// retorna o pedido da fila mais próximo de 'trilha' no sentido 'sentido'
+//   (+1 ou -1), ou -1 se não tem; no empate, o que chegou antes
+static int so_disco_proximo_no_sentido(so_t *self, int trilha, int sentido)
+{
+  int escolhido = -1;
+  int menor_distancia = 0;
+  for (int i = 0; i < self->tam_fila_disco; i++)
+  {
+    int distancia = (so_disco_trilha(self->fila_disco[i].slot) - trilha) * sentido;
+    if (distancia < 0) continue;
+    if (escolhido == -1 || distancia < menor_distancia)
+    {
+      escolhido = i;
+      menor_distancia = distancia;
+    }
+  }
+  return escolhido;
+}
+
+// escolhe o próximo pedido da fila (que não está vazia) a ser atendido
+static int so_disco_escolhe_pedido(so_t *self, int trilha)
+{
+  int escolhido = 0;
+  switch (DISK_SCHEDULER)
+  {
+    case DISK_FCFS:
+      break;
+
+    case DISK_SSTF:
+      for (int i = 1; i < self->tam_fila_disco; i++)
+      {
+        int d = abs(so_disco_trilha(self->fila_disco[i].slot) - trilha);
+        int d_escolhido = abs(so_disco_trilha(self->fila_disco[escolhido].slot) - trilha);
+        if (d < d_escolhido) escolhido = i;
+      }
+      break;
+
+    case DISK_SCAN:
+      escolhido = so_disco_proximo_no_sentido(self, trilha, self->sentido_disco);
+      if (escolhido == -1)
+      {
+        self->sentido_disco = -self->sentido_disco;
+        escolhido = so_disco_proximo_no_sentido(self, trilha, self->sentido_disco);
+      }
+      break;
+
+    case DISK_C_LOOK:
+      escolhido = so_disco_proximo_no_sentido(self, trilha, 1);
+      if (escolhido == -1)
+      {
+        // volta para o início: o mais próximo a partir da trilha 0
+        escolhido = so_disco_proximo_no_sentido(self, 0, 1);
+      }
+      break;
+  }
+  return escolhido;
+}
+
+// se a controladora está livre e tem pedido na fila, manda atender o próximo
+static void so_disco_inicia_proximo(so_t *self)
+{
+  if (self->disco_ocupado || self->tam_fila_disco == 0)
+  {
+    return;
+  }
+
+  int trilha;
+  if (es_le(self->es, D_DISCO_TRILHA, &trilha) != ERR_OK)
+  {
+    console_printf("SO: problema no acesso à trilha do disco");
+    self->erro_interno = true;
+    return;
+  }
+
+  int i = so_disco_escolhe_pedido(self, trilha);
+  so_pedido_disco_t pedido = self->fila_disco[i];
+  // tira da fila mantendo a ordem de chegada dos outros
+  self->tam_fila_disco--;
+  memmove(&self->fila_disco[i], &self->fila_disco[i + 1],
+          (self->tam_fila_disco - i) * sizeof(so_pedido_disco_t));
+
+  if (es_escreve(self->es, D_DISCO_BLOCO, pedido.slot) != ERR_OK
+      || es_escreve(self->es, D_DISCO_QUANTIDADE, pedido.quantidade) != ERR_OK
+      || es_escreve(self->es, D_DISCO_COMANDO, pedido.escrita ? DISCO_ESCREVE : DISCO_LE) != ERR_OK)
+  {
+    console_printf("SO: problema no acesso à controladora do disco");
+    self->erro_interno = true;
+    return;
+  }
+
+  self->metrics.disk_seek_tracks += abs(so_disco_trilha(pedido.slot) - trilha);
+  self->disco_em_uso = pedido;
+  self->disco_ocupado = true;
+}
+
+// faz um pedido de acesso a 'quantidade' slots do disco a partir de 'slot',
+//   esperado pelo processo 'proc' (NULL se ninguém espera)
+static void so_disco_pede(so_t *self, int slot, int quantidade, bool escrita,
+                          process_t *proc)
+{
+  if (self->tam_fila_disco == self->cap_fila_disco)
+  {
+    self->cap_fila_disco = self->cap_fila_disco == 0 ? 8 : 2 * self->cap_fila_disco;
+    self->fila_disco = realloc(self->fila_disco, self->cap_fila_disco * sizeof(so_pedido_disco_t));
+    assert(self->fila_disco != NULL);
+  }
+
+  so_pedido_disco_t *pedido = &self->fila_disco[self->tam_fila_disco++];
+  pedido->slot = slot;
+  pedido->quantidade = quantidade;
+  pedido->escrita = escrita;
+  pedido->proc = proc;
+  pedido->chegada = self->latest_clock;
+
+  if (self->tam_fila_disco > self->metrics.disk_max_queue)
+  {
+    self->metrics.disk_max_queue = self->tam_fila_disco;
+  }
+
+  so_disco_inicia_proximo(self);
+}
+
+// se a página no quadro foi alterada desde que veio do disco, copia ela de
+//   volta para o disco, zera o bit de alteração e pede a gravação ao disco
+//   (ninguém espera por ela)
+// retorna true se copiou
+static bool so_grava_quadro_se_alterado(so_t *self, int quadro)
+{
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  process_t *dono = self->process_table[bloco->user];
+  tabpag_t *tabela = proc_get_tab_pag(dono);
+
+  if (!tabpag_bit_alteracao(tabela, bloco->page))
+  {
+    return false;
   }
 
+  // encontra onde escrever de volta
+  int slot = so_slot_disco(self, dono, bloco->page, true);
+  if (so_copia_quadro_para_disco(self, quadro, slot) != ERR_OK)
+  {
+    console_printf("Erro na escrita no tratamento de page fault");
+    return false;
+  }
+
+  tabpag_zera_bit_alteracao(tabela, bloco->page);
+  so_disco_pede(self, slot, 1, true, NULL);
+  return true;
+}
+
+// tira a página do quadro (que deve estar limpo) da memória do processo dono
+static void so_retira_pagina_do_quadro(so_t *self, int quadro)
+{
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  process_t *dono = self->process_table[bloco->user];
+
+  console_printf("SO: Removeu o conteúdo do bloco %d usado pela página %d do processo #%d", quadro, bloco->page, proc_get_ID(dono));
+
+  so_encerra_antecipacao(self, quadro, true);
+
+  // invalida a página nas tabelas dos outros processos que compartilham o
+  //   quadro, e na do dono
+  for (int i = 1; bloco->refs > 1 && i < self->process_counter; i++)
+  {
+    process_t *proc = self->process_table[i];
+    if (proc != dono && so_proc_mapeia_quadro(self, proc, quadro))
+    {
+      tabpag_invalida_pagina(proc_get_tab_pag(proc), bloco->page);
+      bloco->refs--;
+    }
+  }
+  tabpag_invalida_pagina(proc_get_tab_pag(dono), bloco->page);
+  so_esquece_slot_do_quadro(self, quadro);
+  bloco->refs = 0;
+  so_desocupa_quadro(self, quadro, dono);
 }
 
-static void so_swap_pagina(so_t *self, int end_causador)
+// substitui uma página da memória pela que causou a falta
+// retorna o slot do disco de onde a página foi lida, ou -1 se não tinha
+//   quadro que pudesse ser substituído
+static int so_swap_pagina(so_t *self, int end_causador)
 {
   int to_remove_mem_block = choose_purged_mem_block(self);
   if (to_remove_mem_block == -1)
   {
     console_printf("SO: Não foi possível realizar swap - mem. cheia e bloqueada");
-    return;
+    return -1;
   }
-  
 
-  process_t *outgoing_process = self->process_table[self->mem_tracker[to_remove_mem_block].user];
   process_t *incoming_process = self->current_process;
 
-  if (outgoing_process != NULL)
+  // trata possível alteração e necessidade de writeback na memória secundária
+  if (so_grava_quadro_se_alterado(self, to_remove_mem_block))
+  {
+    self->metrics.sync_writebacks++;
+  }
+  so_retira_pagina_do_quadro(self, to_remove_mem_block);
+
+  // lê a página
+  int slot = so_slot_disco(self, incoming_process, end_causador/TAM_PAGINA, false);
+  if (so_copia_disco_para_quadro(self, slot, to_remove_mem_block) != ERR_OK)
+  {
+    console_printf("Erro na leitura no tratamento de page fault");
+    return -1;
+  }
+
+  so_ocupa_quadro(self, to_remove_mem_block, incoming_process, end_causador/TAM_PAGINA);
+  so_mapeia_pagina(self, incoming_process, end_causador/TAM_PAGINA, to_remove_mem_block, slot);
+
+  console_printf("SO: Inseriu no bloco %d a página %d do processo #%d", to_remove_mem_block, end_causador/TAM_PAGINA, proc_get_ID(incoming_process));
+  return slot;
+}
+
+// a página do processo, protegida porque o quadro é (ou foi) compartilhado,
+//   vai ser escrita: se só este processo mapeia o quadro, tira a proteção;
+//   senão, dá ao processo uma cópia do quadro (cópia na escrita), retirando
+//   uma página da memória se não tiver quadro livre
+// retorna true se a página ficou na memória e pode ser escrita; se o quadro
+//   escolhido para a cópia for o próprio quadro compartilhado, ele sai da
+//   memória e a página vai ser lida de novo na próxima falta
+static bool so_quebra_compartilhamento(so_t *self, process_t *proc, int pagina)
+{
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  int quadro;
+  if (tabela == NULL || tabpag_traduz(tabela, pagina, &quadro) != ERR_OK)
   {
-    // trata possível alteração e necessidade de writeback na memória secundária
-    tabpag_t *outgoing_page_table = proc_get_tab_pag(outgoing_process);
-    int outgoing_page = self->mem_tracker[to_remove_mem_block].page;
+    return false;
+  }
 
-    // encontra onde escrever de volta
-    int disk_write_address = proc_get_disk_address(outgoing_process) + (outgoing_page * TAM_PAGINA);
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  if (bloco->refs <= 1)
+  {
+    so_esquece_slot_do_quadro(self, quadro);
+    tabpag_protege_pagina(tabela, pagina, false);
+    self->metrics.cow_unshares++;
+    return true;
+  }
 
+  int copia = frame_alloc_get(self->frames);
+  if (copia == -1)
+  {
+    copia = choose_purged_mem_block(self);
+    if (copia == -1)
+    {
+      return false;
+    }
 
-    // escreve de volta se foi alterada
-    if (tabpag_bit_alteracao(outgoing_page_table, outgoing_page))
+    if (so_grava_quadro_se_alterado(self, copia))
     {
-      for (int i = 0; i < TAM_PAGINA; i++)
-      {
-        int v;
-        if (mem_le(self->mem, to_remove_mem_block*TAM_PAGINA + i, &v) != ERR_OK)
-        {
-          console_printf("Erro na leitura no tratamento de page fault");
-          return;
-        }
-        
-        if (mem_escreve(self->disk, disk_write_address + i, v) != ERR_OK) 
-        {
-          console_printf("Erro na escrita no tratamento de page fault");
-          return;
-        }
-      }
+      self->metrics.sync_writebacks++;
     }
+    so_retira_pagina_do_quadro(self, copia);
 
-    console_printf("SO: Removeu o conteúdo do bloco %d usado pela página %d do processo #%d", to_remove_mem_block, outgoing_page, proc_get_ID(outgoing_process));
+    if (copia == quadro)
+    {
+      bloco->used = false;
+      frame_alloc_put(self->frames, quadro);
+      return false;
+    }
+  }
 
-    // invalida página na tabela do processo de saída
-    tabpag_invalida_pagina(outgoing_page_table, self->mem_tracker[to_remove_mem_block].page);
+  for (int i = 0; i < TAM_PAGINA; i++)
+  {
+    int valor;
+    mem_le(self->mem, quadro * TAM_PAGINA + i, &valor);
+    mem_escreve(self->mem, copia * TAM_PAGINA + i, valor);
   }
-  
 
-  int end_disk_ini = proc_get_disk_address(incoming_process) + end_causador - end_causador%TAM_PAGINA;
+  so_solta_quadro_compartilhado(self, quadro, proc);
+  so_ocupa_quadro(self, copia, proc, pagina);
+  tabpag_define_quadro(tabela, pagina, copia);
+  self->metrics.cow_copies++;
+  return true;
+}
 
-  // lê a página
-  for (int i = 0; i < TAM_PAGINA; i++)
+// prepara a página do processo para ser escrita, separando-a se ela é
+//   compartilhada
+// retorna false se ela continua protegida na memória, porque não teve quadro
+//   para a cópia; se o quadro compartilhado foi o escolhido para sair, a
+//   página agora só está no disco, e a escrita vai para lá (ou causa falta)
+static bool so_pagina_gravavel(so_t *self, process_t *proc, int pagina)
+{
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  if (tabela == NULL || !tabpag_pagina_protegida(tabela, pagina)) return true;
+  if (so_quebra_compartilhamento(self, proc, pagina)) return true;
+
+  int quadro;
+  return tabpag_traduz(tabela, pagina, &quadro) != ERR_OK;
+}
+
+// escrita numa página protegida
+// a instrução é repetida quando o processo voltar a executar; sem quadro para
+//   a cópia, o processo espera alguma leitura do disco terminar, como na falta
+//   de página (bloco_info -1 põe na fila wait_quadro)
+static void so_trata_falta_protecao(so_t *self)
+{
+  int end_causador = proc_get_complemento(self->current_process);
+  if (!so_pagina_gravavel(self, self->current_process, end_causador/TAM_PAGINA))
   {
-    int v;
-    if (mem_le(self->disk, end_disk_ini + i, &v) != ERR_OK)
+    so_bloqueia_proc(self, self->current_process, AGUARDA_DISCO, -1);
+  }
+}
+
+// duplicação da memória de um processo (SO_FORK)
+// o filho recebe os slots do pai (cada um ganha uma referência) e mapeia os
+//   mesmos quadros, protegidos nas duas tabelas; nada é copiado aqui, a
+//   primeira escrita de um dos dois numa página dá a ele uma cópia só dele
+// um quadro só é compartilhado se tem o mesmo conteúdo do slot, então as
+//   páginas alteradas do pai são gravadas antes
+// retorna quantas páginas na memória ficaram compartilhadas
+static int so_duplica_memoria(so_t *self, process_t *pai, process_t *filho)
+{
+  tabpag_t *tab_pai = proc_get_tab_pag(pai);
+  tabpag_t *tab_filho = proc_get_tab_pag(filho);
+  int compartilhadas = 0;
+
+  for (int pagina = 0; pagina < proc_get_num_pages(pai); pagina++)
+  {
+    int quadro;
+    bool residente = tabpag_traduz(tab_pai, pagina, &quadro) == ERR_OK;
+    // um quadro de outro dono só é mapeado protegido, e não está alterado
+    if (residente && self->mem_tracker[quadro].user == proc_get_ID(pai)
+        && so_grava_quadro_se_alterado(self, quadro))
     {
-      console_printf("Erro na leitura no tratamento de page fault");
-      return;
+      self->metrics.fork_writebacks++;
     }
-    
-    if (mem_escreve(self->mem, to_remove_mem_block*TAM_PAGINA + i, v) != ERR_OK) 
+
+    // o slot é lido depois da gravação, que pode ter dado um slot novo ao pai
+    int slot = proc_get_swap_slot(pai, pagina);
+    if (slot == -1)
     {
-      console_printf("Erro na escrita no tratamento de page fault");
-      return;
+      continue;
+    }
+    swap_share(self->swap, slot);
+    proc_set_swap_slot(filho, pagina, slot);
+
+    if (residente)
+    {
+      mem_block_t *bloco = &self->mem_tracker[quadro];
+      if (bloco->slot == -1)
+      {
+        tabpag_protege_pagina(tab_pai, pagina, true);
+        bloco->slot = slot;
+        self->quadro_do_slot[slot] = quadro;
+      }
+      tabpag_define_quadro(tab_filho, pagina, quadro);
+      tabpag_protege_pagina(tab_filho, pagina, true);
+      bloco->refs++;
+      compartilhadas++;
     }
   }
 
-  self->mem_tracker[to_remove_mem_block].used = true;
-  self->mem_tracker[to_remove_mem_block].user = proc_get_ID(incoming_process);
-  self->mem_tracker[to_remove_mem_block].page = end_causador/TAM_PAGINA;
-  self->mem_tracker[to_remove_mem_block].chance = false;
+  return compartilhadas;
+}
 
-  if(es_le(self->es, D_RELOGIO_INSTRUCOES, &self->mem_tracker[to_remove_mem_block].cicles) != ERR_OK)
+// leitura antecipada (fault-around)
+// na falta de página, as páginas seguintes do processo que estão nos slots
+//   seguintes do disco são lidas no mesmo pedido, se tiver quadro livre
+// a janela de cada processo (quantas páginas a mais) aumenta a cada página
+//   antecipada que foi usada e cai pela metade a cada uma que saiu da memória
+//   sem ser usada
+
+// se a página do quadro foi antecipada e já foi acessada, conta o acerto e
+//   aumenta a janela do processo dono
+// deve ser chamada antes de zerar o bit de acesso da página
+static void so_confere_antecipacao(so_t *self, int quadro)
+{
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  if (!bloco->prefetched)
   {
-    console_printf("Erro crítico de atualização da memória");
+    return;
+  }
+
+  process_t *dono = self->process_table[bloco->user];
+  if (!so_bit_acesso_quadro(self, quadro, false) && bloco->age == 0)
+  {
+    return;
+  }
+
+  bloco->prefetched = false;
+  self->metrics.prefetch_hits++;
+  int janela = proc_get_prefetch_window(dono);
+  if (janela < PREFETCH_JANELA_MAX)
+  {
+    proc_set_prefetch_window(dono, janela + 1);
   }
+}
 
-  tabpag_t *incoming_page_table = proc_get_tab_pag(incoming_process);
-  tabpag_define_quadro(incoming_page_table, end_causador/TAM_PAGINA, to_remove_mem_block);
+// a página do quadro vai sair da memória: se foi antecipada e não foi usada,
+//   conta o desperdício e, se 'reduz', diminui a janela do processo dono
+static void so_encerra_antecipacao(so_t *self, int quadro, bool reduz)
+{
+  so_confere_antecipacao(self, quadro);
 
-  console_printf("SO: Inseriu no bloco %d a página %d do processo #%d", to_remove_mem_block, end_causador/TAM_PAGINA, proc_get_ID(incoming_process));
+  mem_block_t *bloco = &self->mem_tracker[quadro];
+  if (!bloco->prefetched)
+  {
+    return;
+  }
+
+  bloco->prefetched = false;
+  self->metrics.prefetch_wasted++;
+  if (reduz)
+  {
+    process_t *dono = self->process_table[bloco->user];
+    int janela = proc_get_prefetch_window(dono) / 2;
+    proc_set_prefetch_window(dono, janela > 0 ? janela : 1);
+  }
+}
+
+// coloca nos quadros livres as páginas seguintes a 'pagina' (que está no slot
+//   'slot'), enquanto estiverem nos slots seguintes do disco e não estiverem
+//   na memória, até a janela do processo
+// retorna quantas páginas foram colocadas
+static int so_antecipa_paginas(so_t *self, process_t *proc, int pagina, int slot)
+{
+  // as páginas já antecipadas que foram usadas aumentam a janela antes
+  for (int q = proc_get_frame_list(proc); q != -1; q = self->mem_tracker[q].next_owned)
+  {
+    so_confere_antecipacao(self, q);
+  }
+
+  tabpag_t *tabela = proc_get_tab_pag(proc);
+  int janela = proc_get_prefetch_window(proc);
+  int trazidas = 0;
+  while (trazidas < janela && frame_alloc_free_count(self->frames) > 0)
+  {
+    int vizinha = pagina + 1 + trazidas;
+    int quadro;
+    if (vizinha >= proc_get_num_pages(proc)
+        || proc_get_swap_slot(proc, vizinha) != slot + 1 + trazidas
+        || tabpag_traduz(tabela, vizinha, &quadro) == ERR_OK
+        || self->quadro_do_slot[slot + 1 + trazidas] != -1)
+    {
+      break;
+    }
+
+    quadro = frame_alloc_get(self->frames);
+    if (so_copia_disco_para_quadro(self, slot + 1 + trazidas, quadro) != ERR_OK)
+    {
+      frame_alloc_put(self->frames, quadro);
+      break;
+    }
+
+    so_ocupa_quadro(self, quadro, proc, vizinha);
+    // não foi acessada: não deve parecer mais usada que as outras
+    self->mem_tracker[quadro].age = 0;
+    self->mem_tracker[quadro].prefetched = true;
+    so_mapeia_pagina(self, proc, vizinha, quadro, slot + 1 + trazidas);
+    trazidas++;
+  }
+
+  self->metrics.prefetch_pages += trazidas;
+  return trazidas;
 }
 
 static void so_trata_page_fault(so_t *self)
 {
-  proc_get_metrics_ptr(self->current_process)->page_faults++;
   int end_causador = proc_get_complemento(self->current_process);
 
-  bool has_free_block = is_any_block_free(self);
-  if(has_free_block)
-  {
-    console_printf("SO: tratando falha de página com bloco livre");
-    so_trata_page_fault_espaco_encontrado(self, end_causador);
+  // a página não é do programa: o acesso é inválido, e o processo morre
+  if (end_causador < 0
+      || proc_get_swap_slot(self->current_process, end_causador/TAM_PAGINA) == -1)
+  {
+    console_printf("SO: processo #%d acessou o endereço inválido %d",
+                   proc_get_ID(self->current_process), end_causador);
+    so_mata_proc(self, self->current_process);
+    return;
+  }
+
+  proc_get_metrics_ptr(self->current_process)->page_faults++;
+
+  // a página pode estar na memória para outro processo do mesmo programa
+  if (so_compartilha_quadro(self, self->current_process, end_causador/TAM_PAGINA))
+  {
+    console_printf("SO: página %d do processo #%d compartilhada", end_causador/TAM_PAGINA, proc_get_ID(self->current_process));
+    return;
+  }
+
+  int slot;
+  bool has_free_block = frame_alloc_free_count(self->frames) > 0;
+  if(has_free_block)
+  {
+    console_printf("SO: tratando falha de página com bloco livre");
+    slot = so_trata_page_fault_espaco_encontrado(self, end_causador);
+  }
+
+  else
+  {
+    console_printf("SO: tratando falha de página sem bloco livre");
+    slot = so_swap_pagina(self, end_causador);
+  }
+
+  // o processo espera a leitura da página (e das seguintes, antecipadas no
+  //   mesmo pedido); se não conseguiu quadro (todos presos por leituras em
+  //   andamento), espera alguma leitura terminar para tentar de novo (o
+  //   bloco_info -1 põe na fila wait_quadro)
+  if (slot != -1)
+  {
+    int quantidade = 1 + so_antecipa_paginas(self, self->current_process,
+                                             end_causador/TAM_PAGINA, slot);
+    so_disco_pede(self, slot, quantidade, false, self->current_process);
+  }
+  so_bloqueia_proc(self, self->current_process, AGUARDA_DISCO, slot);
+}
+
+// paginador: executado a cada interrupção do relógio (inclusive com a CPU
+//   parada), fora do tratamento das faltas de página
+// - grava no disco as páginas alteradas que estão nos próximos quadros que o
+//   relógio vai examinar, para que quando forem escolhidas não precisem ser
+//   gravadas durante a falta
+// - mantém pelo menos PAGER_QUADROS_LIVRES quadros livres, retirando páginas
+//   da memória com o algoritmo de substituição, para que a falta de página só
+//   precise ler a página que falta
+static void so_pager(so_t *self)
+{
+  int n = self->num_physical_pages;
+  int gravados = 0;
+  for (int k = 0; k < n && gravados < PAGER_LOTE_ESCRITA; k++)
+  {
+    int quadro = (self->clock_hand + k) % n;
+    mem_block_t *bloco = &self->mem_tracker[quadro];
+    if (!bloco->used || bloco->user == 0)
+    {
+      continue;
+    }
+
+    if (so_grava_quadro_se_alterado(self, quadro))
+    {
+      self->metrics.pager_writebacks++;
+      gravados++;
+    }
   }
 
-  else
+  while (frame_alloc_free_count(self->frames) < PAGER_QUADROS_LIVRES)
   {
-    console_printf("SO: tratando falha de página sem bloco livre");
-    so_swap_pagina(self, end_causador);
-  }
+    int quadro = choose_purged_mem_block(self);
+    if (quadro == -1)
+    {
+      break;
+    }
 
-  so_bloqueia_proc(self, self->current_process, AGUARDA_DISCO, TEMPO_BLOQUEIO_DISCO);
+    if (so_grava_quadro_se_alterado(self, quadro))
+    {
+      self->metrics.pager_writebacks++;
+    }
+    so_retira_pagina_do_quadro(self, quadro);
+    self->mem_tracker[quadro].used = false;
+    frame_alloc_put(self->frames, quadro);
+    self->metrics.pager_evictions++;
+  }
 }
 
 // interrupção gerada quando a CPU identifica um erro
@@ -1050,6 +2972,12 @@ static void so_trata_irq_err_cpu(so_t *self)
     return;
   }
 
+  if(err == ERR_PAG_PROTEGIDA)
+  {
+    so_trata_falta_protecao(self);
+    return;
+  }
+
   if(err == ERR_INSTR_INV)
   {
     console_printf("SO: caguei");
@@ -1067,17 +2995,123 @@ static void so_trata_irq_err_cpu(so_t *self)
 // interrupção gerada quando o timer expira
 static void so_trata_irq_relogio(so_t *self)
 {
-  // rearma o interruptor do relógio e reinicializa o timer para a próxima interrupção
-  err_t e1, e2;
-  e1 = es_escreve(self->es, D_RELOGIO_INTERRUPCAO, 0); // desliga o sinalizador de interrupção
-  e2 = es_escreve(self->es, D_RELOGIO_TIMER, INTERVALO_INTERRUPCAO);
-  if (e1 != ERR_OK || e2 != ERR_OK) {
+  // a interrupção do relógio vai para todas as CPUs; só a primeira a atender
+  //   encontra o sinalizador ligado e faz o que é do sistema todo (envelhecer
+  //   os quadros, ...); nas outras, ela só serve para o escalonamento
+  int tem_int;
+  if (es_le(self->es, D_RELOGIO_INTERRUPCAO, &tem_int) != ERR_OK) {
+    console_printf("SO: problema no acesso ao relógio");
+    self->erro_interno = true;
+    return;
+  }
+  if (tem_int == 0) return;
+
+  // rearma o interruptor do relógio; o timer é reprogramado no fim do
+  //   atendimento (so_programa_relogio), se ainda for útil
+  if (es_escreve(self->es, D_RELOGIO_INTERRUPCAO, 0) != ERR_OK) {
     console_printf("SO: problema da reinicialização do timer");
     self->erro_interno = true;
   }
   // t1: deveria tratar a interrupção
   //   por exemplo, decrementa o quantum do processo corrente, quando se tem
   //   um escalonador com quantum
+  // o quantum é descontado em toda entrada no SO (so_desconta_quantum); aqui
+  //   fica a manutenção periódica, a cada INTERVALO_INTERRUPCAO: com o timer
+  //   sob demanda a interrupção pode ter vindo antes, pelo fim de um quantum
+  if (self->latest_clock - self->ultima_manutencao < INTERVALO_INTERRUPCAO) return;
+  self->ultima_manutencao = self->latest_clock;
+
+  if (SWAP_ALGORITHM == AGING)
+  {
+    so_envelhece_quadros(self);
+  }
+
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE3
+      && ++self->tics_desde_impulso >= MLFQ_INTERVALO_IMPULSO)
+  {
+    self->tics_desde_impulso = 0;
+    so_mlfq_impulso(self);
+  }
+
+  so_pager(self);
+}
+
+// interrupção gerada quando chega entrada em algum terminal
+// a interrupção não diz qual; atende os processos esperando leitura, na ordem
+//   em que bloquearam, nos terminais que têm entrada disponível
+static void so_trata_irq_teclado(so_t *self)
+{
+  for (int t = 0; t < N_TERMINAIS; t++)
+  {
+    process_t *proc;
+    while ((proc = runqueue_peek(self->wait_teclado[t])) != NULL
+           && so_trata_pendencia_leitura(self, proc))
+      ;
+  }
+}
+
+// interrupção gerada quando a saída de algum terminal volta a aceitar caracteres
+static void so_trata_irq_tela(so_t *self)
+{
+  for (int t = 0; t < N_TERMINAIS; t++)
+  {
+    process_t *proc;
+    while ((proc = runqueue_peek(self->wait_tela[t])) != NULL
+           && so_trata_pendencia_escrita(self, proc))
+      ;
+  }
+}
+
+// interrupção gerada quando o disco termina um pedido
+// desbloqueia quem esperava por ele e os que esperavam um quadro (a página
+//   lida deixou de prender o seu), e manda atender o próximo pedido
+static void so_trata_irq_disco(so_t *self)
+{
+  if (es_escreve(self->es, D_DISCO_INTERRUPCAO, 0) != ERR_OK)
+  {
+    console_printf("SO: problema no acesso à controladora do disco");
+    self->erro_interno = true;
+    return;
+  }
+
+  if (self->disco_ocupado)
+  {
+    so_pedido_disco_t *pedido = &self->disco_em_uso;
+    self->disco_ocupado = false;
+    if (pedido->escrita)
+    {
+      self->metrics.disk_writes++;
+    }
+
+    else
+    {
+      self->metrics.disk_reads++;
+    }
+    self->metrics.disk_wait_time += self->latest_clock - pedido->chegada;
+
+    // o processo pode ter morrido enquanto esperava
+    process_t *proc = pedido->proc;
+    if (proc != NULL && proc_get_state(proc) == PROC_BLOQUEADO
+        && proc_get_block_type(proc) == AGUARDA_DISCO)
+    {
+      so_desbloqueia_proc(self, proc);
+    }
+  }
+
+  process_t *proc;
+  while ((proc = runqueue_peek(self->wait_quadro)) != NULL)
+  {
+    so_desbloqueia_proc(self, proc);
+  }
+
+  so_disco_inicia_proximo(self);
+}
+
+// interrupção pedida por outra CPU, para esta entrar no SO
+// o que ela queria (matar o processo corrente, mata_corrente) já foi feito na
+//   entrada (so_atende_interrupcao); o resto é o escalonamento
+static void so_trata_irq_ipi(so_t *self)
+{
 }
 
 // foi gerada uma interrupção para a qual o SO não está preparado
@@ -1092,16 +3126,20 @@ static void so_trata_irq_desconhecida(so_t *self, int irq)
 // funções auxiliares para cada chamada de sistema
 static void so_chamada_le(so_t *self);
 static void so_chamada_escr(so_t *self);
+static void so_chamada_le_bloco(so_t *self);
+static void so_chamada_escr_bloco(so_t *self);
 static void so_chamada_cria_proc(so_t *self);
 static void so_chamada_mata_proc(so_t *self);
 static void so_chamada_espera_proc(so_t *self);
+static void so_chamada_fork(so_t *self);
+static void so_chamada_nice(so_t *self);
 
 static void so_trata_irq_chamada_sistema(so_t *self)
 {
   // a identificação da chamada está no registrador A
   // t1: com processos, o reg A tá no descritor do processo corrente
   int id_chamada;
-  if (mem_le(self->mem, IRQ_END_A, &id_chamada) != ERR_OK) {
+  if (mem_le(self->mem, self->cpu_atual->area_irq + IRQ_END_A, &id_chamada) != ERR_OK) {
     console_printf("SO: erro no acesso ao id da chamada de sistema");
     self->erro_interno = true;
     return;
@@ -1114,6 +3152,12 @@ static void so_trata_irq_chamada_sistema(so_t *self)
     case SO_ESCR:
       so_chamada_escr(self);
       break;
+    case SO_LE_BLOCO:
+      so_chamada_le_bloco(self);
+      break;
+    case SO_ESCR_BLOCO:
+      so_chamada_escr_bloco(self);
+      break;
     case SO_CRIA_PROC:
       so_chamada_cria_proc(self);
       break;
@@ -1123,6 +3167,12 @@ static void so_trata_irq_chamada_sistema(so_t *self)
     case SO_ESPERA_PROC:
       so_chamada_espera_proc(self);
       break;
+    case SO_FORK:
+      so_chamada_fork(self);
+      break;
+    case SO_NICE:
+      so_chamada_nice(self);
+      break;
     default:
       console_printf("SO: chamada de sistema desconhecida (%d)", id_chamada);
       // t1: deveria matar o processo
@@ -1213,6 +3263,67 @@ static void so_chamada_escr(so_t *self)
   proc_set_A(self->current_process, 0);
 }
 
+// implementação da chamada se sistema SO_LE_BLOCO
+// lê os caracteres disponíveis na entrada do processo (bloqueia se não tiver)
+static void so_chamada_le_bloco(so_t *self)
+{
+  process_t *proc = self->current_process;
+  proc_io_t *io = proc_get_io_ptr(proc);
+
+  int end, tam;
+  if (!so_le_descritor_bloco(self, proc, &end, &tam))
+  {
+    proc_set_A(proc, -1);
+    return;
+  }
+
+  io->tam = tam;
+  io->pos = 0;
+  io->end_destino = end;
+  if (!so_destino_gravavel(self, proc))
+  {
+    so_repete_chamada_sem_quadro(self, proc);
+    return;
+  }
+
+  if (!so_le_bloco(self, proc))
+  {
+    so_bloqueia_proc(self, proc, AGUARDA_ENTRADA, proc_get_device(proc));
+  }
+}
+
+// implementação da chamada se sistema SO_ESCR_BLOCO
+// copia os caracteres para o buffer do processo e escreve o que puder; o resto
+//   é escrito quando a tela interromper
+static void so_chamada_escr_bloco(so_t *self)
+{
+  process_t *proc = self->current_process;
+  proc_io_t *io = proc_get_io_ptr(proc);
+
+  int end, tam;
+  if (!so_le_descritor_bloco(self, proc, &end, &tam))
+  {
+    proc_set_A(proc, -1);
+    return;
+  }
+
+  for (int i = 0; i < tam; i++)
+  {
+    if (so_acessa_mem_do_processo(self, proc, end + i, &io->buf[i], false) != ERR_OK)
+    {
+      proc_set_A(proc, -1);
+      return;
+    }
+  }
+
+  io->tam = tam;
+  io->pos = 0;
+  if (!so_escreve_bloco(self, proc))
+  {
+    so_bloqueia_proc(self, proc, AGUARDA_SAIDA, proc_get_device(proc));
+  }
+}
+
 // implementação da chamada se sistema SO_CRIA_PROC
 // cria um processo
 static void so_chamada_cria_proc(so_t *self)
@@ -1252,27 +3363,66 @@ static void so_chamada_mata_proc(so_t *self)
 
   int read_x = proc_get_X(self->current_process);
 
+  process_t *killed;
   if (read_x == 0)
   {
-    proc_set_state(self->current_process, PROC_MORTO);
+    killed = self->current_process;
   }
 
   else
   {
-    proc_set_state(self->process_table[read_x], PROC_MORTO);
+    killed = self->process_table[read_x];
+  }
+
+  // se está executando em outra CPU, a tabela de páginas dele ainda está em
+  //   uso lá; ele morre quando ela entrar no SO, o que é forçado por uma
+  //   interrupção entre processadores
+  so_cpu_t *outra = so_cpu_executando(self, killed);
+  if (outra != NULL)
+  {
+    outra->mata_corrente = true;
+    if (es_escreve(self->es, D_IPI, outra->id) != ERR_OK)
+    {
+      console_printf("SO: problema no pedido de interrupção para a CPU %d", outra->id);
+      self->erro_interno = true;
+    }
+    return;
+  }
+
+  so_mata_proc(self, killed);
+}
+
+// mata o processo, que não pode estar executando em outra CPU
+static void so_mata_proc(so_t *self, process_t *killed)
+{
+  // se estava bloqueado, sai da fila de espera
+  if (proc_get_state(killed) == PROC_BLOQUEADO)
+  {
+    runqueue_remove(so_fila_de_espera(self, killed), killed);
   }
+
+  proc_set_state(killed, PROC_MORTO);
   
+  // libera os quadros ocupados pelo processo, que não vão mais ser acessados,
+  // e os slots da memória secundária
+  so_libera_quadros_do_processo(self, killed);
+  so_libera_swap_do_processo(self, killed);
+  so_descarta_imagens_sem_uso(self);
+
   // destroi a tabela de páginas do processo
-  // mas nao libera a memória física
-  tabpag_t *page_table = proc_get_tab_pag(self->current_process);
-  free(page_table);
+  // (com tabpag_destroi, para a MMU esquecer as traduções dela que estão na TLB)
+  tabpag_destroi(proc_get_tab_pag(killed));
+  proc_set_tab_pag(killed, NULL);
 
-  self->current_process = NULL;
+  if (killed == self->current_process)
+  {
+    self->current_process = NULL;
+  }
 
-  void *v;
-  self->queue = list_pop(self->queue, &v);
+  so_tira_dos_prontos(self, killed);
 
-  // T1: deveria matar um processo
+  // acorda quem estava esperando por ele
+  so_trata_pendencia_espera(self, proc_get_ID(killed));
 }
 
 // implementação da chamada se sistema SO_ESPERA_PROC
@@ -1283,15 +3433,62 @@ static void so_chamada_espera_proc(so_t *self)
   // ainda sem suporte a processos, retorna erro -1
 
   int awaits_who = proc_get_X(self->current_process);
+  if (awaits_who <= 0 || awaits_who >= self->process_counter)
+  {
+    proc_set_A(self->current_process, -1);
+    return;
+  }
+
+  // se o processo já morreu, não tem o que esperar
+  if (proc_get_state(self->process_table[awaits_who]) == PROC_MORTO)
+  {
+    return;
+  }
+
   so_bloqueia_proc(self, self->current_process, AGUARDA_PROC, awaits_who);
 }
 
+// implementação da chamada de sistema SO_FORK
+// cria um processo filho, cópia do processo corrente: continua do mesmo
+//   ponto, com os mesmos registradores (menos A), o mesmo terminal, o mesmo
+//   nice e a mesma memória, compartilhada até ser alterada
+static void so_chamada_fork(so_t *self)
+{
+  process_t *pai = self->current_process;
+  process_t *filho = proc_create(self->process_counter);
+
+  proc_set_PC(filho, proc_get_PC(pai));
+  proc_set_X(filho, proc_get_X(pai));
+  proc_set_A(filho, 0);
+  proc_set_device(filho, proc_get_device(pai));
+  proc_set_nice(filho, proc_get_nice(pai));
+  proc_set_prefetch_window(filho, proc_get_prefetch_window(pai));
+
+  int compartilhadas = so_duplica_memoria(self, pai, filho);
+  so_registra_proc(self, filho);
+  self->metrics.forks++;
+  self->metrics.fork_shared_pages += compartilhadas;
+
+  console_printf("SO: processo #%d duplicado no #%d, %d páginas compartilhadas",
+                 proc_get_ID(pai), proc_get_ID(filho), compartilhadas);
+  proc_set_A(pai, proc_get_ID(filho));
+}
+
+// implementação da chamada de sistema SO_NICE
+// muda o nice do processo corrente para X (limitado ao intervalo válido); só
+//   faz diferença no escalonador justo
+static void so_chamada_nice(so_t *self)
+{
+  proc_set_nice(self->current_process, proc_get_X(self->current_process));
+  proc_set_A(self->current_process, proc_get_nice(self->current_process));
+}
+
 // CARGA DE PROGRAMA {{{1
 
 // funções auxiliares
 static int so_carrega_programa_na_memoria_fisica(so_t *self, programa_t *programa);
 static int so_carrega_programa_na_memoria_virtual(so_t *self,
-                                                  programa_t *programa,
+                                                  char *nome_do_executavel,
                                                   process_t *processo);
 
 // carrega o programa na memória de um processo ou na memória física se NENHUM_PROCESSO
@@ -1301,20 +3498,17 @@ static int so_carrega_programa(so_t *self, process_t *processo,
 {
   console_printf("SO: carga de '%s'", nome_do_executavel);
 
+  if (processo != NENHUM_PROCESSO) {
+    return so_carrega_programa_na_memoria_virtual(self, nome_do_executavel, processo);
+  }
+
   programa_t *programa = prog_cria(nome_do_executavel);
   if (programa == NULL) {
     console_printf("Erro na leitura do programa '%s'\n", nome_do_executavel);
     return -1;
   }
 
-  int end_carga;
-  if (processo == NENHUM_PROCESSO) {
-    end_carga = so_carrega_programa_na_memoria_fisica(self, programa);
-  } else {
-    end_carga = so_carrega_programa_na_memoria_virtual(self, programa, processo);
-    proc_set_disk_address(processo, end_carga);
-    end_carga = 0;
-  }
+  int end_carga = so_carrega_programa_na_memoria_fisica(self, programa);
 
   prog_destroi(programa);
   return end_carga;
@@ -1326,6 +3520,7 @@ static void so_marca_uso_memoria(so_t *self, int end_ini, int end_fim, int proc_
   {
     self->mem_tracker[address/TAM_PAGINA].used = true;
     self->mem_tracker[address/TAM_PAGINA].user = proc_id;
+    frame_alloc_take(self->frames, address/TAM_PAGINA);
   }
 }
 
@@ -1350,44 +3545,218 @@ static int so_carrega_programa_na_memoria_fisica(so_t *self, programa_t *program
   return end_ini;
 }
 
+// procura o programa entre os que já estão na memória secundária
+static so_imagem_t *so_busca_imagem(so_t *self, char *nome_do_executavel)
+{
+  for (int i = 0; i < self->num_imagens; i++)
+  {
+    if (strcmp(self->imagens[i].nome, nome_do_executavel) == 0)
+    {
+      return &self->imagens[i];
+    }
+  }
+
+  return NULL;
+}
+
+// lê o programa e coloca na memória secundária, em slots novos
+// retorna NULL se não conseguir
+static so_imagem_t *so_cria_imagem(so_t *self, char *nome_do_executavel)
+{
+  if (strlen(nome_do_executavel) >= sizeof(self->imagens[0].nome)) return NULL;
+
+  programa_t *programa = prog_cria(nome_do_executavel);
+  if (programa == NULL) {
+    console_printf("Erro na leitura do programa '%s'\n", nome_do_executavel);
+    return NULL;
+  }
+
+  int tamanho = prog_tamanho(programa);
+  int num_pages = (tamanho + TAM_PAGINA - 1) / TAM_PAGINA;
+  int *slots = malloc(num_pages * sizeof(int));
+  assert(slots != NULL);
+
+  for (int pagina = 0; pagina < num_pages; pagina++)
+  {
+    int dados[TAM_PAGINA];
+    for (int i = 0; i < TAM_PAGINA; i++)
+    {
+      int end_virt = pagina * TAM_PAGINA + i;
+      dados[i] = end_virt < tamanho ? prog_dado(programa, end_virt) : 0;
+    }
+    slots[pagina] = so_aloca_slot(self);
+    disco_escreve_pagina(self->disk, slots[pagina], dados);
+  }
+  prog_destroi(programa);
+
+  self->imagens = realloc(self->imagens, (self->num_imagens + 1) * sizeof(so_imagem_t));
+  assert(self->imagens != NULL);
+  so_imagem_t *imagem = &self->imagens[self->num_imagens++];
+  strcpy(imagem->nome, nome_do_executavel);
+  imagem->num_pages = num_pages;
+  imagem->slots = slots;
+
+  console_printf("carregado na memória secundária V0-%d, %d páginas",
+                 tamanho - 1, num_pages);
+  return imagem;
+}
+
 static int so_carrega_programa_na_memoria_virtual(so_t *self,
-                                                  programa_t *programa,
+                                                  char *nome_do_executavel,
                                                   process_t *processo)
 {
-  // meu: carregará programa na memória secundária
+  // o programa é carregado na memória secundária uma vez só; as páginas do
+  //   processo são mapeadas como inválidas, e são colocadas na memória
+  //   principal por demanda, a partir dos slots da imagem, que são
+  //   compartilhados até o processo alterar a página (ver so_end_disco)
+  so_imagem_t *imagem = so_busca_imagem(self, nome_do_executavel);
+  if (imagem == NULL) {
+    imagem = so_cria_imagem(self, nome_do_executavel);
+    if (imagem == NULL) return -1;
+  } else {
+    console_printf("compartilhando %d páginas da memória secundária",
+                   imagem->num_pages);
+  }
 
+  for (int pagina = 0; pagina < imagem->num_pages; pagina++)
+  {
+    swap_share(self->swap, imagem->slots[pagina]);
+    proc_set_swap_slot(processo, pagina, imagem->slots[pagina]);
+  }
 
-  // t2: isto tá furado...
-  // está simplesmente lendo para o próximo quadro que nunca foi ocupado,
-  //   nem testa se tem memória disponível
-  // com memória virtual, a forma mais simples de implementar a carga de um
-  //   programa é carregá-lo para a memória secundária, e mapear todas as páginas
-  //   da tabela de páginas do processo como inválidas. Assim, as páginas serão
-  //   colocadas na memória principal por demanda. Para simplificar ainda mais, a
-  //   memória secundária pode ser alocada da forma como a principal está sendo
-  //   alocada aqui (sem reuso)
-  
-  // carrega o programa na memória secundária
-  int end_disk_ini = self->disk_pointer;
-  int end_disk = end_disk_ini;
+  return 0;
+}
+
+// descarta as imagens de programa que nenhum processo usa mais: nenhum slot
+//   delas tem outra referência além da própria imagem
+// um programa descartado é carregado de novo na próxima vez que for executado
+static void so_descarta_imagens_sem_uso(so_t *self)
+{
+  int i = 0;
+  while (i < self->num_imagens)
+  {
+    so_imagem_t *imagem = &self->imagens[i];
+    bool em_uso = false;
+    for (int pagina = 0; pagina < imagem->num_pages && !em_uso; pagina++)
+    {
+      em_uso = swap_refcount(self->swap, imagem->slots[pagina]) > 1;
+    }
+
+    if (em_uso)
+    {
+      i++;
+      continue;
+    }
 
-  int end_virt_ini = 0;
-  int end_virt_fim = end_virt_ini + prog_tamanho(programa) - 1;
+    for (int pagina = 0; pagina < imagem->num_pages; pagina++)
+    {
+      swap_release(self->swap, imagem->slots[pagina]);
+    }
+    free(imagem->slots);
+    self->imagens[i] = self->imagens[--self->num_imagens];
+  }
+}
 
-  self->disk_pointer = end_disk_ini + end_virt_fim + 1;
+// MEMÓRIA SECUNDÁRIA {{{1
 
-  for (int end_virt = end_virt_ini; end_virt <= end_virt_fim; end_virt++) {
-    if (mem_escreve(self->disk, end_disk, prog_dado(programa, end_virt)) != ERR_OK) {
-      console_printf("Erro na carga da memória, end virt %d fís %d\n", end_virt,
-                     end_disk);
+// ocupa um slot da memória secundária; se não tiver, dobra o tamanho do disco
+static int so_aloca_slot(so_t *self)
+{
+  int slot = swap_alloc(self->swap);
+  if (slot == -1)
+  {
+    int num_paginas = 2 * disco_num_paginas(self->disk);
+    if (disco_aumenta(self->disk, num_paginas) != ERR_OK)
+    {
+      console_printf("SO: não foi possível aumentar a memória secundária");
+      self->erro_interno = true;
       return -1;
     }
-    end_disk++;
+    int antigo = swap_num_slots(self->swap);
+    swap_grow(self->swap, num_paginas);
+    self->quadro_do_slot = realloc(self->quadro_do_slot, num_paginas * sizeof(int));
+    assert(self->quadro_do_slot != NULL);
+    for (int i = antigo; i < num_paginas; i++)
+    {
+      self->quadro_do_slot[i] = -1;
+    }
+    console_printf("SO: memória secundária aumentada para %d páginas", num_paginas);
+
+    slot = swap_alloc(self->swap);
+  }
+
+  if (swap_used_slots(self->swap) > self->metrics.max_swap_slots)
+  {
+    self->metrics.max_swap_slots = swap_used_slots(self->swap);
   }
-  console_printf("carregado na memória secundária V%d-%d DISK%d-%d",
-                 end_virt_ini, end_virt_fim, end_disk_ini, end_disk - 1);
 
-  return end_disk_ini;
+  return slot;
+}
+
+// retorna o slot do disco com a página 'pagina' do processo, ou -1 se a
+//   página não é do programa
+// se for para escrita e o slot for compartilhado, a página ganha uma cópia
+//   só dela antes (cópia na escrita)
+static int so_slot_disco(so_t *self, process_t *proc, int pagina, bool escrita)
+{
+  int slot = proc_get_swap_slot(proc, pagina);
+  int dados[TAM_PAGINA];
+
+  if (slot != -1 && escrita && swap_refcount(self->swap, slot) > 1)
+  {
+    int copia = so_aloca_slot(self);
+    disco_le_pagina(self->disk, slot, dados);
+    disco_escreve_pagina(self->disk, copia, dados);
+    swap_release(self->swap, slot);
+    slot = copia;
+    proc_set_swap_slot(proc, pagina, slot);
+  }
+
+  return slot;
+}
+
+// retorna o endereço no disco do endereço virtual 'end_virt' do processo
+static int so_end_disco(so_t *self, process_t *proc, int end_virt, bool escrita)
+{
+  int slot = so_slot_disco(self, proc, end_virt / TAM_PAGINA, escrita);
+  return slot * TAM_PAGINA + end_virt % TAM_PAGINA;
+}
+
+// copia uma página inteira entre o disco e a memória principal
+static err_t so_copia_disco_para_quadro(so_t *self, int slot, int quadro)
+{
+  int dados[TAM_PAGINA];
+  err_t err = disco_le_pagina(self->disk, slot, dados);
+  for (int i = 0; err == ERR_OK && i < TAM_PAGINA; i++)
+  {
+    err = mem_escreve(self->mem, quadro * TAM_PAGINA + i, dados[i]);
+  }
+  return err;
+}
+
+static err_t so_copia_quadro_para_disco(so_t *self, int quadro, int slot)
+{
+  int dados[TAM_PAGINA];
+  for (int i = 0; i < TAM_PAGINA; i++)
+  {
+    err_t err = mem_le(self->mem, quadro * TAM_PAGINA + i, &dados[i]);
+    if (err != ERR_OK) return err;
+  }
+  return disco_escreve_pagina(self->disk, slot, dados);
+}
+
+// libera os slots do processo (os compartilhados só perdem uma referência)
+static void so_libera_swap_do_processo(so_t *self, process_t *proc)
+{
+  for (int pagina = 0; pagina < proc_get_num_pages(proc); pagina++)
+  {
+    int slot = proc_get_swap_slot(proc, pagina);
+    if (slot != -1)
+    {
+      swap_release(self->swap, slot);
+    }
+  }
+  proc_clear_swap_slots(proc);
 }
 
 // ACESSO À MEMÓRIA DOS PROCESSOS {{{1
@@ -1404,11 +3773,9 @@ static bool so_copia_str_do_processo(so_t *self, int tam, char str[tam],
   if (processo == NENHUM_PROCESSO) return false;
   for (int indice_str = 0; indice_str < tam; indice_str++) {
     int caractere;
-    // não tem memória virtual implementada, posso usar a mmu para traduzir
-    //   os endereços e acessar a memória
-    if (mmu_le(self->mmu, end_virt + indice_str, &caractere, usuario) != ERR_OK) {
-      // se não está na memória principal, busca na memória secundária (disco)
-      mem_le(self->disk, proc_get_disk_address(self->current_process) + end_virt + indice_str, &caractere);
+    // se não está na memória principal, busca na memória secundária (disco)
+    if (so_acessa_mem_do_processo(self, processo, end_virt + indice_str, &caractere, false) != ERR_OK) {
+      return false;
     }
     if (caractere < 0 || caractere > 255) {
       return false;
@@ -1458,13 +3825,64 @@ void so_show_metrics(so_t *self)
   console_printf("\n");
   console_printf("##########       Configuração do SO     ##########");
   console_printf("-> Intervalo interrupção: %d instruções", INTERVALO_INTERRUPCAO);
-  console_printf("-> Tempo de quantum:      %d interrupções", DEFAULT_QUANTUM);
+  console_printf("-> Timer:                 %s", TIMER_DINAMICO ? "sob demanda" : "periódico");
+  console_printf("-> Tempo de quantum:      %d instruções", DEFAULT_QUANTUM);
   console_printf("-> Escalonador usado:     tipo %d", SCHEDULER_TYPE);
   console_printf("\n");
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE3)
+  {
+    console_printf("##########        Escalonador MLFQ      ##########");
+    for (int nivel = 0; nivel < MLFQ_NIVEIS; nivel++)
+    {
+      console_printf("-> Nível %d (quantum %3d): %d instruções executando, %d pronto", nivel, MLFQ_QUANTUM(nivel), self->metrics.mlfq_executing_time[nivel], self->metrics.mlfq_ready_time[nivel]);
+    }
+    console_printf("-> Mudanças de nível:   %d para baixo, %d para cima", self->metrics.mlfq_demotions, self->metrics.mlfq_promotions);
+    console_printf("-> Impulsos:            %d (a cada %d interrupções do relógio)", self->metrics.mlfq_boosts, MLFQ_INTERVALO_IMPULSO);
+    console_printf("\n");
+  }
+  if (SCHEDULER_TYPE == SCHEDULER_TYPE4)
+  {
+    console_printf("##########        Escalonador justo     ##########");
+    for (int i = 1; i < self->process_counter; i++)
+    {
+      process_t *proc = self->process_table[i];
+      console_printf("-> Processo #%02d: nice %3d, tempo virtual %ld", proc_get_ID(proc), proc_get_nice(proc), proc_get_vruntime(proc));
+    }
+    console_printf("-> Preempções por tempo virtual: %d", self->metrics.cfs_preemptions);
+    console_printf("\n");
+  }
   console_printf("##########        Métricas Gerais       ##########");
   console_printf("-> Número de processos criados: %d processos", self->metrics.total_processes);
   console_printf("-> Tempo de execução:           %d instruções", self->metrics.total_runtime);
   console_printf("-> Tempo total de ócio:         %d instruções", self->metrics.total_halted_time);
+  console_printf("-> Tempo com a CPU parada:      %d instruções", self->metrics.total_idle_time);
+  int timer_off_time = self->metrics.timer_off_time;
+  if (self->timer_off_since != -1)
+  {
+    timer_off_time += self->latest_clock - self->timer_off_since;
+  }
+  console_printf("-> Tempo com o timer desligado: %d instruções", timer_off_time);
+  console_printf("\n");
+  console_printf("##########             CPUs             ##########");
+  for (int i = 0; i < self->n_cpus; i++)
+  {
+    so_cpu_t *cpu = &self->cpus[i];
+    console_printf("-> CPU %d: %d interrupções, %d instruções parada, %d roubos, %d esperas pelo SO", cpu->id, cpu->interrupts, cpu->idle_time, cpu->steals, cpu->kernel_waits);
+    if (self->latest_clock > 0)
+    {
+      console_printf("   utilização: %.2f%%", 100.0 * (self->latest_clock - cpu->idle_time) / self->latest_clock);
+    }
+  }
+  console_printf("-> Roubos de processo:  %d processos, %d migrações", self->metrics.steals, self->metrics.migrations);
+  int entradas = 0;
+  for (int i = 0; i < self->n_cpus; i++)
+  {
+    entradas += self->cpus[i].interrupts;
+  }
+  if (entradas > 0)
+  {
+    console_printf("-> Disputa pelo SO:     %d entradas com outra CPU esperando (%.2f%%)", self->metrics.contended_entries, 100.0 * self->metrics.contended_entries / entradas);
+  }
   console_printf("\n");
   console_printf("##########         Interrupções         ##########");
   console_printf("-> Tipo IRQ_RESET:     %d interrupções", self->metrics.interrupts[IRQ_RESET]);
@@ -1473,6 +3891,59 @@ void so_show_metrics(so_t *self)
   console_printf("-> Tipo IRQ_RELOGIO:   %d interrupções", self->metrics.interrupts[IRQ_RELOGIO]);
   console_printf("-> Tipo IRQ_TECLADO:   %d interrupções", self->metrics.interrupts[IRQ_TECLADO]);
   console_printf("-> Tipo IRQ_TELA:      %d interrupções", self->metrics.interrupts[IRQ_TELA]);
+  console_printf("-> Tipo IRQ_DISCO:     %d interrupções", self->metrics.interrupts[IRQ_DISCO]);
+  console_printf("-> Tipo IRQ_IPI:       %d interrupções", self->metrics.interrupts[IRQ_IPI]);
+  console_printf("\n");
+  console_printf("##########           Paginação          ##########");
+  console_printf("-> Gravações na falta:  %d páginas", self->metrics.sync_writebacks);
+  console_printf("-> Gravações do pager:  %d páginas", self->metrics.pager_writebacks);
+  console_printf("-> Liberadas pelo pager: %d páginas", self->metrics.pager_evictions);
+  console_printf("-> Slots de swap:       %d ocupados, máximo %d, de %d", swap_used_slots(self->swap), self->metrics.max_swap_slots, swap_num_slots(self->swap));
+  console_printf("-> Faltas compartilhadas: %d páginas (sem ler o disco)", self->metrics.shared_maps);
+  console_printf("-> Cópias na escrita:   %d cópias, %d sem cópia", self->metrics.cow_copies, self->metrics.cow_unshares);
+  console_printf("-> Duplicações (fork):  %d processos, %d páginas compartilhadas, %d gravadas", self->metrics.forks, self->metrics.fork_shared_pages, self->metrics.fork_writebacks);
+  console_printf("-> Antecipadas:         %d páginas (janela máxima %d)", self->metrics.prefetch_pages, PREFETCH_JANELA_MAX);
+  console_printf("-> Antecipadas usadas:  %d páginas, %d desperdiçadas", self->metrics.prefetch_hits, self->metrics.prefetch_wasted);
+  if (self->metrics.prefetch_hits + self->metrics.prefetch_wasted > 0)
+  {
+    console_printf("-> Acerto antecipação:  %.2f%%", 100.0 * self->metrics.prefetch_hits / (self->metrics.prefetch_hits + self->metrics.prefetch_wasted));
+  }
+  console_printf("\n");
+  console_printf("##########             Disco            ##########");
+  console_printf("-> Escalonador:         tipo %d", DISK_SCHEDULER);
+  console_printf("-> Pedidos atendidos:   %d leituras, %d gravações", self->metrics.disk_reads, self->metrics.disk_writes);
+  console_printf("-> Trilhas percorridas: %d trilhas", self->metrics.disk_seek_tracks);
+  int disk_requests = self->metrics.disk_reads + self->metrics.disk_writes;
+  if (disk_requests > 0)
+  {
+    console_printf("-> Tempo médio:         %.2f instruções por pedido", (double)self->metrics.disk_wait_time / disk_requests);
+  }
+  console_printf("-> Maior fila:          %d pedidos", self->metrics.disk_max_queue);
+  console_printf("\n");
+  if (self->metrics.clock_selections > 0)
+  {
+    console_printf("##########   Substituição (relógio)     ##########");
+    console_printf("-> Escolhas de vítima:  %d escolhas", self->metrics.clock_selections);
+    console_printf("-> Quadros examinados:  %d quadros", self->metrics.clock_scanned);
+    console_printf("-> Média por escolha:   %.2f quadros", (double)self->metrics.clock_scanned / self->metrics.clock_selections);
+    console_printf("-> Maior varredura:     %d quadros", self->metrics.clock_max_scan);
+    console_printf("\n");
+  }
+  console_printf("##########              TLB             ##########");
+  long tlb_hits = 0, tlb_misses = 0;
+  for (int i = 0; i < self->n_cpus; i++)
+  {
+    long acertos, falhas;
+    mmu_estatisticas_tlb(self->cpus[i].mmu, &acertos, &falhas);
+    tlb_hits += acertos;
+    tlb_misses += falhas;
+  }
+  console_printf("-> Acertos:             %ld traduções", tlb_hits);
+  console_printf("-> Falhas:              %ld traduções", tlb_misses);
+  if (tlb_hits + tlb_misses > 0)
+  {
+    console_printf("-> Taxa de acerto:      %.2f%%", 100.0 * tlb_hits / (tlb_hits + tlb_misses));
+  }
   
   console_printf("\n");
   console_printf("##########           Processos          ##########");
@@ -15,8 +15,14 @@ typedef struct sys_metrics_t sys_metrics_t;
 #include "es.h"
 #include "console.h" // só para uma gambiarra
 
-so_t *so_cria(cpu_t *cpu, mem_t *mem, mmu_t *mmu,
-              es_t *es, console_t *console);
+// cria o SO para um computador com 'n_cpus' CPUs, cada uma com a sua MMU
+//   (cpus[i] usa mmus[i]), compartilhando a memória e os dispositivos
+// o SO atende uma CPU de cada vez: uma interrupção é tratada inteira dentro
+//   da instrução CHAMAC da CPU que a aceitou
+// o primeiro processo executa o programa do arquivo 'programa_inicial'
+so_t *so_cria(int n_cpus, cpu_t *cpus[n_cpus], mmu_t *mmus[n_cpus],
+              mem_t *mem, es_t *es, console_t *console,
+              char *programa_inicial);
 void so_destroi(so_t *self);
 
 // Chamadas de sistema
@@ -42,6 +48,23 @@ void so_destroi(so_t *self);
 // retorna em A: 0 se OK ou um código de erro negativo
 #define SO_ESCR        2
 
+// Chamadas para entrada e saída em bloco
+// Recebem em X o endereço de um descritor com dois valores na memória do
+//   processo: o endereço do primeiro caractere e o número de caracteres.
+// São tratados no máximo PROC_TAM_BUF_ES caracteres por chamada (ver proc.h).
+
+// escreve um bloco de caracteres no dispositivo de saída do processo
+// os caracteres são copiados para o SO na chamada; o processo fica
+//   bloqueado até que todos tenham sido escritos
+// retorna em A: o número de caracteres escritos ou um código de erro negativo
+#define SO_ESCR_BLOCO 10
+
+// lê caracteres do dispositivo de entrada do processo
+// bloqueia até ter pelo menos um caractere disponível; lê os que estiverem
+//   disponíveis, até o número pedido
+// retorna em A: o número de caracteres lidos ou um código de erro negativo
+#define SO_LE_BLOCO   11
+
 // #define SO_ABRE        3
 // #define SO_FECHA       4
 // #define SO_SEL_LE      5
@@ -78,4 +101,19 @@ void so_destroi(so_t *self);
 // retorna sem bloquear, com erro, se não existir processo com esse pid
 #define SO_ESPERA_PROC 9
 
+// cria um processo novo, cópia do processo que realiza esta chamada
+// o processo criado continua a execução do mesmo ponto, com os mesmos
+//   registradores e o mesmo terminal; a memória dele é uma cópia da memória
+//   do processo chamador no momento da chamada (as páginas são compartilhadas
+//   entre os dois até uma delas ser alterada)
+// retorna em A: no processo chamador, o pid do processo criado; no processo
+//   criado, 0
+#define SO_FORK       12
+
+// muda o nice do processo que realiza esta chamada: a prioridade dele no
+//   escalonador justo, de -20 (maior) a 19 (menor); o padrão é 0
+// recebe em X o nice novo, que é limitado a esse intervalo
+// retorna em A: o nice que ficou valendo
+#define SO_NICE       13
+
 #endif // SO_H
@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "swap.h"
+
+// o bit i do mapa está ligado se o slot i está ocupado
+// a busca por um slot livre começa na palavra do mapa onde a anterior parou,
+// e pula as palavras cheias
+
+#define BITS_POR_PALAVRA 64
+
+struct swap_t
+{
+    int num_slots;
+    int used_slots;
+    int num_words;
+    uint64_t *used_map;
+    int *refcount;
+    int hint;   // palavra do mapa onde começar a procurar
+};
+
+static int words_for(int num_slots)
+{
+    return (num_slots + BITS_POR_PALAVRA - 1) / BITS_POR_PALAVRA;
+}
+
+swap_t *swap_create(int num_slots)
+{
+    swap_t *sw = malloc(sizeof(swap_t));
+    assert(sw != NULL);
+
+    sw->num_slots = 0;
+    sw->used_slots = 0;
+    sw->num_words = 0;
+    sw->used_map = NULL;
+    sw->refcount = NULL;
+    sw->hint = 0;
+    swap_grow(sw, num_slots);
+
+    return sw;
+}
+
+void swap_destroy(swap_t *sw)
+{
+    free(sw->used_map);
+    free(sw->refcount);
+    free(sw);
+}
+
+void swap_grow(swap_t *sw, int num_slots)
+{
+    if (num_slots <= sw->num_slots) return;
+
+    int num_words = words_for(num_slots);
+    sw->used_map = realloc(sw->used_map, num_words * sizeof(uint64_t));
+    sw->refcount = realloc(sw->refcount, num_slots * sizeof(int));
+    assert(sw->used_map != NULL && sw->refcount != NULL);
+
+    for (int w = sw->num_words; w < num_words; w++)
+    {
+        sw->used_map[w] = 0;
+    }
+
+    for (int s = sw->num_slots; s < num_slots; s++)
+    {
+        sw->refcount[s] = 0;
+    }
+
+    // os bits além do último slot ficam ligados, para nunca serem escolhidos
+    int extra = num_words * BITS_POR_PALAVRA - num_slots;
+    if (extra > 0)
+    {
+        sw->used_map[num_words - 1] |= ~UINT64_C(0) << (BITS_POR_PALAVRA - extra);
+    }
+
+    // na palavra que era a última, os bits dos novos slots voltam a ser livres
+    if (sw->num_words > 0)
+    {
+        int last = sw->num_words - 1;
+        for (int s = sw->num_slots; s < num_slots && s < (last + 1) * BITS_POR_PALAVRA; s++)
+        {
+            sw->used_map[last] &= ~(UINT64_C(1) << (s % BITS_POR_PALAVRA));
+        }
+    }
+
+    sw->num_slots = num_slots;
+    sw->num_words = num_words;
+}
+
+int swap_alloc(swap_t *sw)
+{
+    for (int i = 0; i < sw->num_words; i++)
+    {
+        int w = (sw->hint + i) % sw->num_words;
+        if (sw->used_map[w] == ~UINT64_C(0)) continue;
+
+        int bit = __builtin_ctzll(~sw->used_map[w]);
+        int slot = w * BITS_POR_PALAVRA + bit;
+        sw->used_map[w] |= UINT64_C(1) << bit;
+        sw->refcount[slot] = 1;
+        sw->used_slots++;
+        sw->hint = w;
+
+        return slot;
+    }
+
+    return -1;
+}
+
+void swap_share(swap_t *sw, int slot)
+{
+    assert(slot >= 0 && slot < sw->num_slots && sw->refcount[slot] > 0);
+    sw->refcount[slot]++;
+}
+
+void swap_release(swap_t *sw, int slot)
+{
+    assert(slot >= 0 && slot < sw->num_slots && sw->refcount[slot] > 0);
+
+    sw->refcount[slot]--;
+    if (sw->refcount[slot] == 0)
+    {
+        sw->used_map[slot / BITS_POR_PALAVRA] &= ~(UINT64_C(1) << (slot % BITS_POR_PALAVRA));
+        sw->used_slots--;
+    }
+}
+
+int swap_refcount(swap_t *sw, int slot)
+{
+    return sw->refcount[slot];
+}
+
+int swap_num_slots(swap_t *sw)
+{
+    return sw->num_slots;
+}
+
+int swap_used_slots(swap_t *sw)
+{
+    return sw->used_slots;
+}
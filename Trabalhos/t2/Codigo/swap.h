@@ -0,0 +1,37 @@
+#ifndef SWAP_H
+#define SWAP_H
+
+#include <stdbool.h>
+
+// alocador de espaço na memória secundária (disco), em slots do tamanho de
+// uma página
+// os slots livres são marcados em um mapa de bits; cada slot ocupado tem um
+// contador de referências, para que vários processos possam usar o mesmo
+// slot (páginas de um programa que ainda não foram alteradas)
+// o número de slots pode aumentar (swap_grow), quando o disco aumenta
+
+typedef struct swap_t swap_t;
+
+swap_t *swap_create(int num_slots);
+void swap_destroy(swap_t *sw);
+
+// aumenta o número de slots para 'num_slots' (os novos ficam livres)
+void swap_grow(swap_t *sw, int num_slots);
+
+// ocupa um slot livre, com uma referência, e retorna o seu número
+// retorna -1 se não tiver slot livre
+int swap_alloc(swap_t *sw);
+
+// acrescenta uma referência a um slot ocupado
+void swap_share(swap_t *sw, int slot);
+
+// retira uma referência do slot; o slot fica livre quando não tiver mais
+void swap_release(swap_t *sw, int slot);
+
+// número de referências ao slot (0 se está livre)
+int swap_refcount(swap_t *sw, int slot);
+
+int swap_num_slots(swap_t *sw);
+int swap_used_slots(swap_t *sw);
+
+#endif
@@ -17,9 +17,16 @@ typedef struct {
   bool acessada;
   // a página foi alterada ou não
   bool alterada;
+  // a página não pode ser escrita
+  bool protegida;
 } descritor_t;
 
 struct tabpag_t {
+  // identificador do espaço de endereçamento
+  int asid;
+  // função para sincronizar com cópias externas da tabela (a TLB), e seu argumento
+  tabpag_f_sincroniza_t f_sincroniza;
+  void *arg_sincroniza;
   // número de descritores na tabela (pode ser 0)
   int tam_tab;
   // vetor com os descritores
@@ -28,18 +35,50 @@ struct tabpag_t {
   descritor_t *tabela;
 };
 
+// próximo identificador de espaço de endereçamento a usar
+static int proximo_asid = 1;
+
 tabpag_t *tabpag_cria(void)
 {
   tabpag_t *self = malloc(sizeof(*self));
   assert(self != NULL);
+  self->asid = proximo_asid++;
+  self->f_sincroniza = NULL;
+  self->arg_sincroniza = NULL;
   self->tam_tab = 0;
   self->tabela = NULL;
   return self;
 }
 
+// chama a função de sincronização, se houver
+static void tabpag__sincroniza(tabpag_t *self, int pagina, bool esquece)
+{
+  if (self->f_sincroniza != NULL) {
+    self->f_sincroniza(self->arg_sincroniza, self, pagina, esquece);
+  }
+}
+
+int tabpag_asid(tabpag_t *self)
+{
+  return self->asid;
+}
+
+void tabpag_define_f_sincroniza(tabpag_t *self, tabpag_f_sincroniza_t f,
+                                void *arg)
+{
+  // quem tinha cópias antes (a TLB de outra MMU) não vai mais ser avisado
+  if (self->f_sincroniza != NULL
+      && (self->f_sincroniza != f || self->arg_sincroniza != arg)) {
+    tabpag__sincroniza(self, -1, true);
+  }
+  self->f_sincroniza = f;
+  self->arg_sincroniza = arg;
+}
+
 void tabpag_destroi(tabpag_t *self)
 {
   if (self != NULL) {
+    tabpag__sincroniza(self, -1, true);
     if (self->tabela != NULL) free(self->tabela);
     free(self);
   }
@@ -54,6 +93,7 @@ static bool tabpag__pagina_valida(tabpag_t *self, int pagina)
 
 void tabpag_invalida_pagina(tabpag_t *self, int pagina)
 {
+  tabpag__sincroniza(self, pagina, true);
   // página já é inválida -- não faz nada
   if (!tabpag__pagina_valida(self, pagina)) return;
   // página não é a última da tabela -- marca como inválida
@@ -95,11 +135,13 @@ static void tabpag__insere_pagina(tabpag_t *self, int pagina)
 void tabpag_define_quadro(tabpag_t *self, int pagina, int quadro)
 {
   assert(pagina >= 0);
+  tabpag__sincroniza(self, pagina, true);
   tabpag__insere_pagina(self, pagina);
   self->tabela[pagina].quadro = quadro;
   self->tabela[pagina].valida = true;
   self->tabela[pagina].acessada = false;
   self->tabela[pagina].alterada = false;
+  self->tabela[pagina].protegida = false;
 }
 
 void tabpag_marca_bit_acesso(tabpag_t *self, int pagina, bool alteracao)
@@ -113,22 +155,46 @@ void tabpag_marca_bit_acesso(tabpag_t *self, int pagina, bool alteracao)
 
 void tabpag_zera_bit_acesso(tabpag_t *self, int pagina)
 {
+  tabpag__sincroniza(self, pagina, false);
   if (!tabpag__pagina_valida(self, pagina)) return;
   self->tabela[pagina].acessada = false;
 }
 
+void tabpag_zera_bit_alteracao(tabpag_t *self, int pagina)
+{
+  tabpag__sincroniza(self, pagina, false);
+  if (!tabpag__pagina_valida(self, pagina)) return;
+  self->tabela[pagina].alterada = false;
+}
+
 bool tabpag_bit_acesso(tabpag_t *self, int pagina)
 {
+  tabpag__sincroniza(self, pagina, false);
   if (!tabpag__pagina_valida(self, pagina)) return false;
   return self->tabela[pagina].acessada;
 }
 
 bool tabpag_bit_alteracao(tabpag_t *self, int pagina)
 {
+  tabpag__sincroniza(self, pagina, false);
   if (!tabpag__pagina_valida(self, pagina)) return false;
   return self->tabela[pagina].alterada;
 }
 
+void tabpag_protege_pagina(tabpag_t *self, int pagina, bool protegida)
+{
+  // a TLB guarda a proteção junto com a tradução
+  tabpag__sincroniza(self, pagina, true);
+  if (!tabpag__pagina_valida(self, pagina)) return;
+  self->tabela[pagina].protegida = protegida;
+}
+
+bool tabpag_pagina_protegida(tabpag_t *self, int pagina)
+{
+  if (!tabpag__pagina_valida(self, pagina)) return false;
+  return self->tabela[pagina].protegida;
+}
+
 err_t tabpag_traduz(tabpag_t *self, int pagina, int *pquadro)
 {
   if (!tabpag__pagina_valida(self, pagina)) return ERR_PAG_AUSENTE;
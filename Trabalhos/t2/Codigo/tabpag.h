@@ -10,7 +10,8 @@
 // realiza a tradução de números de páginas do espaço de endereçamento
 //   de um processo em números de quadros da memória principal onde essas
 //   páginas estão mapeadas
-// mantém para cada página mapeada um bit de acesso e um bit de alteração
+// mantém para cada página mapeada um bit de acesso, um bit de alteração e um
+//   bit de proteção contra escrita
 
 #include "err.h"
 #include <stdbool.h>
@@ -18,20 +19,40 @@
 // tipo opaco que representa a tabela de páginas
 typedef struct tabpag_t tabpag_t;
 
+// tipo da função chamada pela tabela antes de consultar ou alterar a
+//   informação sobre uma página, para que quem guarda cópias dessa informação
+//   (a TLB da MMU) devolva à tabela os bits de acesso e alteração que ainda não
+//   foram marcados nela, e esqueça a cópia se 'esquece' for true
+// 'pagina' é -1 quando se refere a todas as páginas da tabela
+typedef void (*tabpag_f_sincroniza_t)(void *arg, tabpag_t *tabpag, int pagina,
+                                      bool esquece);
+
 // cria uma tabela de páginas
 // retorna um ponteiro para um descritor, que deverá ser usado em todas
 //   as operações nessa tabela
 // mata o programa em caso de erro (malloc)
 tabpag_t *tabpag_cria(void);
 
+// retorna o identificador do espaço de endereçamento da tabela
+// cada tabela criada tem um identificador diferente, que não é reutilizado
+int tabpag_asid(tabpag_t *self);
+
+// registra a função a ser chamada (com o argumento 'arg') antes de consultar
+//   ou alterar a informação de uma página, para sincronizar com cópias dessa
+//   informação mantidas fora da tabela
+// só uma função é registrada; se já tinha outra, ela é chamada antes para
+//   esquecer todas as páginas (a tabela passou a ser usada por outra MMU)
+void tabpag_define_f_sincroniza(tabpag_t *self, tabpag_f_sincroniza_t f,
+                                void *arg);
+
 // destrói uma tabela de páginas
 // libera a memória ocupara pela tabela
 // nenhuma outra operação pode ser realizada na tabela após esta chamada
 void tabpag_destroi(tabpag_t *self);
 
 // define que a tradução da página 'pagina' deve resultar no quadro 'quadro'
-// essa página é marcada como válida, e os bits de acesso e alteração para essa
-//   página são zerados
+// essa página é marcada como válida, e os bits de acesso, alteração e proteção
+//   para essa página são zerados
 // páginas sem quadro definido são consideradas inválidas
 void tabpag_define_quadro(tabpag_t *self, int pagina, int quadro);
 
@@ -48,6 +69,11 @@ void tabpag_marca_bit_acesso(tabpag_t *self, int pagina, bool alteracao);
 // não faz nada se a página for inválida
 void tabpag_zera_bit_acesso(tabpag_t *self, int pagina);
 
+// zera o bit de alteração da página (depois que ela foi copiada para a
+//   memória secundária); não afeta o bit de acesso
+// não faz nada se a página for inválida
+void tabpag_zera_bit_alteracao(tabpag_t *self, int pagina);
+
 // retorna o valor do bit de acesso à página
 // retorna false se a página for inválida
 bool tabpag_bit_acesso(tabpag_t *self, int pagina);
@@ -56,6 +82,15 @@ bool tabpag_bit_acesso(tabpag_t *self, int pagina);
 // retorna false se a página for inválida
 bool tabpag_bit_alteracao(tabpag_t *self, int pagina);
 
+// liga ou desliga a proteção contra escrita da página; uma escrita numa
+//   página protegida não é feita, e causa o erro ERR_PAG_PROTEGIDA na MMU
+// não faz nada se a página for inválida
+void tabpag_protege_pagina(tabpag_t *self, int pagina, bool protegida);
+
+// retorna o valor do bit de proteção contra escrita da página
+// retorna false se a página for inválida
+bool tabpag_pagina_protegida(tabpag_t *self, int pagina);
+
 // traduz a página 'pagina'; coloca o quadro correspondente na posição apontada
 //   por 'pquadro'
 // retorna ERR_PAG_AUSENTE (e não altera '*pquadro') se a página for inválida
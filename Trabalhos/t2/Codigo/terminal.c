@@ -32,6 +32,12 @@ struct terminal_t {
   enum { normal, rolando, limpando } estado_saida;
   // posicao do caractere que está sendo movido durante uma rolagem
   int pos_rolagem;
+  // arquivos ligados ao terminal no modo lote (NULL se não houver)
+  FILE *arq_entrada;
+  FILE *arq_saida;
+  // pedidos de interrupção pendentes
+  bool int_teclado;
+  bool int_tela;
 };
 
 
@@ -48,6 +54,10 @@ terminal_t *terminal_cria(int tam_linha)
   strcpy(self->entrada, "");
   strcpy(self->saida, "");
   self->estado_saida = normal;
+  self->arq_entrada = NULL;
+  self->arq_saida = NULL;
+  self->int_teclado = false;
+  self->int_tela = false;
 
   return self;
 }
@@ -82,6 +92,28 @@ void terminal_insere_char(terminal_t *self, char ch)
   if (tam >= self->tam_linha-2) return;
   p[tam] = ch;
   p[tam+1] = '\0';
+  // a entrada deixou de estar vazia
+  if (tam == 0) self->int_teclado = true;
+}
+
+void terminal_define_arquivos(terminal_t *self, FILE *entrada, FILE *saida)
+{
+  self->arq_entrada = entrada;
+  self->arq_saida = saida;
+}
+
+// se a entrada estiver vazia, lê uma linha do arquivo de entrada e insere
+//   no terminal, terminada por espaço (como faz o comando 'E' da console)
+static void terminal_le_arquivo(terminal_t *self)
+{
+  if (self->arq_entrada == NULL || !terminal_entrada_vazia(self)) return;
+  int ch;
+  while ((ch = fgetc(self->arq_entrada)) != EOF && ch != '\n') {
+    terminal_insere_char(self, ch);
+  }
+  if (!terminal_entrada_vazia(self)) {
+    terminal_insere_char(self, ' ');
+  }
 }
 
 static bool terminal_pode_imprimir(terminal_t *self)
@@ -92,6 +124,9 @@ static bool terminal_pode_imprimir(terminal_t *self)
 static void terminal_imprime(terminal_t *self, char ch)
 {
   if (terminal_pode_imprimir(self)) {
+    if (self->arq_saida != NULL) {
+      fputc(ch, self->arq_saida);
+    }
     if (ch == '\n') {
       self->estado_saida = limpando;
       return;
@@ -107,10 +142,17 @@ static void terminal_imprime(terminal_t *self, char ch)
   }
 }
 
+// a saída volta a aceitar caracteres
+static void terminal_saida_pronta(terminal_t *self)
+{
+  if (self->estado_saida != normal) self->int_tela = true;
+  self->estado_saida = normal;
+}
+
 void terminal_limpa_saida(terminal_t *self)
 {
   self->saida[0] = '\0';
-  self->estado_saida = normal;
+  terminal_saida_pronta(self);
 }
 
 static void terminal_atualiza_rolagem(terminal_t *self)
@@ -123,7 +165,7 @@ static void terminal_atualiza_rolagem(terminal_t *self)
     self->pos_rolagem++;
     p[self->pos_rolagem] = ' ';
   } else {
-    self->estado_saida = normal;
+    terminal_saida_pronta(self);
   }
 }
 
@@ -134,13 +176,15 @@ static void terminal_atualiza_limpeza(terminal_t *self)
   int tam = strlen(p);
   memmove(p, p+1, tam);
   if (tam <= 1) {
-    self->estado_saida = normal;
+    terminal_saida_pronta(self);
   }
 }
 
 // altera a string de saída em 1 caractere, se estiver rolando ou limpando
+// no modo lote, repõe a entrada a partir do arquivo, se ela tiver esvaziado
 void terminal_tictac(terminal_t *self)
 {
+  terminal_le_arquivo(self);
   switch (self->estado_saida) {
     case normal: 
       break;
@@ -153,6 +197,55 @@ void terminal_tictac(terminal_t *self)
   }
 }
 
+void terminal_avanca(terminal_t *self, int tics)
+{
+  for (int i = 0; i < tics; i++) {
+    terminal_tictac(self);
+    // com a saída parada e a entrada já reposta, os demais tics não mudam nada
+    if (self->estado_saida == normal) break;
+  }
+}
+
+bool terminal_pede_interrupcao(terminal_t *self, irq_t irq)
+{
+  switch (irq) {
+    case IRQ_TECLADO: return self->int_teclado;
+    case IRQ_TELA:    return self->int_tela;
+    default:          return false;
+  }
+}
+
+void terminal_atende_interrupcao(terminal_t *self, irq_t irq)
+{
+  switch (irq) {
+    case IRQ_TECLADO: self->int_teclado = false; break;
+    case IRQ_TELA:    self->int_tela = false;    break;
+    default:          break;
+  }
+}
+
+int terminal_tics_ate_evento(terminal_t *self)
+{
+  int tam = strlen(self->saida);
+  switch (self->estado_saida) {
+    case rolando:
+      // um caractere por tic, da posição de rolagem até o fim da linha
+      return tam - self->pos_rolagem > 1 ? tam - self->pos_rolagem : 1;
+    case limpando:
+      // um caractere por tic, do início da linha
+      return tam > 1 ? tam : 1;
+    case normal:
+      break;
+  }
+  // no modo lote, a entrada vazia é reposta no próximo tic, se o arquivo
+  //   ainda não acabou
+  if (terminal_entrada_vazia(self) && self->arq_entrada != NULL
+      && !feof(self->arq_entrada)) {
+    return 1;
+  }
+  return 0;
+}
+
 char *terminal_txt_entrada(terminal_t *self)
 {
   return self->entrada;
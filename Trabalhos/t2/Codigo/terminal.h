@@ -30,9 +30,19 @@
 //   saída chamando terminal_txt_entrada ou terminal_txt_saida. a console insere
 //   caracteres digitados no terminal chamando terminal_insere_char, e limpa a
 //   linha de saída com terminal_limpa_saida.
+//
+// no modo lote (sem tela), o terminal pode ser ligado a arquivos: o que é
+//   impresso na saída é também escrito em um arquivo, e quando a entrada fica
+//   vazia uma nova linha é lida de outro arquivo, como se tivesse sido digitada.
+//
+// o terminal pede interrupção quando a entrada deixa de estar vazia
+//   (IRQ_TECLADO) e quando a saída volta a aceitar caracteres (IRQ_TELA).
+//   o pedido fica pendente até ser atendido (terminal_atende_interrupcao).
 
 #include <stdbool.h>
+#include <stdio.h>
 #include "es.h"
+#include "irq.h"
 
 typedef struct terminal_t terminal_t;
 
@@ -54,9 +64,30 @@ void terminal_insere_char(terminal_t *self, char ch);
 // limpa a linha de saída (para uso pela console)
 void terminal_limpa_saida(terminal_t *self);
 
+// liga o terminal a arquivos (para uso pela console, no modo lote)
+// os caracteres impressos na saída são também escritos em 'saida'; quando a
+//   entrada estiver vazia, a próxima linha de 'entrada' é inserida nela
+// qualquer um dos dois pode ser NULL; os arquivos não pertencem ao terminal
+void terminal_define_arquivos(terminal_t *self, FILE *entrada, FILE *saida);
+
 // esta função deve ser chamada periodicamente
 void terminal_tictac(terminal_t *self);
 
+// equivale a 'tics' chamadas a terminal_tictac
+void terminal_avanca(terminal_t *self, int tics);
+
+// retorna true se o terminal está pedindo a interrupção 'irq'
+//   (IRQ_TECLADO ou IRQ_TELA)
+bool terminal_pede_interrupcao(terminal_t *self, irq_t irq);
+
+// retira o pedido da interrupção 'irq', que foi aceita pela CPU
+void terminal_atende_interrupcao(terminal_t *self, irq_t irq);
+
+// retorna em quantas unidades de tempo (no mínimo) o estado do terminal pode
+//   mudar sem intervenção da CPU (a saída voltar a aceitar caracteres ou a
+//   entrada ser reposta do arquivo), ou 0 se isso não vai acontecer
+int terminal_tics_ate_evento(terminal_t *self);
+
 // Funções para implementar o protocolo de acesso a um dispositivo pelo
 //   controlador de E/S
 // Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
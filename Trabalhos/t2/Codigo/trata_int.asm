@@ -11,8 +11,8 @@ trata_int
         chamac
         ; o valor de retorno da função chamada é colocado em A
         ; ele representa a vontade do SO de suspender a execução ou retornar
-        ;   da interrupção e executar o processo cujo estado da CPU está no
-        ;   início da memória
+        ;   da interrupção e executar o processo cujo estado está na área
+        ;   de salvamento da CPU
         desvnz suspende
         reti
 suspende
@@ -0,0 +1,162 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "vrqueue.h"
+
+// o heap fica num vetor: os filhos da posição i estão em 2i+1 e 2i+2; cada
+// processo guarda a sua posição (vr_node_t.index), atualizada a cada troca, e
+// o número de chegada (seq), que desempata processos com o mesmo vruntime
+
+#define VRQUEUE_TAM_INICIAL 16
+
+struct vrqueue_t
+{
+    process_t **heap;
+    int size;
+    int capacity;
+    long next_seq;
+};
+
+vrqueue_t *vrqueue_create(void)
+{
+    vrqueue_t *vq = malloc(sizeof(vrqueue_t));
+    assert(vq != NULL);
+
+    vq->capacity = VRQUEUE_TAM_INICIAL;
+    vq->heap = malloc(vq->capacity * sizeof(process_t *));
+    assert(vq->heap != NULL);
+    vq->size = 0;
+    vq->next_seq = 0;
+
+    return vq;
+}
+
+void vrqueue_destroy(vrqueue_t *vq)
+{
+    // os processos não pertencem à fila
+    free(vq->heap);
+    free(vq);
+}
+
+// true se 'a' deve sair da fila antes de 'b'
+static bool vrqueue_antes(process_t *a, process_t *b)
+{
+    long va = proc_get_vruntime(a);
+    long vb = proc_get_vruntime(b);
+    if (va != vb) return va < vb;
+
+    return proc_get_vr_node_ptr(a)->seq < proc_get_vr_node_ptr(b)->seq;
+}
+
+static void vrqueue_coloca(vrqueue_t *vq, int pos, process_t *proc)
+{
+    vq->heap[pos] = proc;
+    proc_get_vr_node_ptr(proc)->index = pos;
+}
+
+// sobe o processo da posição 'pos' enquanto ele vem antes do pai
+static void vrqueue_sobe(vrqueue_t *vq, int pos)
+{
+    process_t *proc = vq->heap[pos];
+    while (pos > 0)
+    {
+        int pai = (pos - 1) / 2;
+        if (!vrqueue_antes(proc, vq->heap[pai])) break;
+
+        vrqueue_coloca(vq, pos, vq->heap[pai]);
+        pos = pai;
+    }
+
+    vrqueue_coloca(vq, pos, proc);
+}
+
+// desce o processo da posição 'pos' enquanto algum filho vem antes dele
+static void vrqueue_desce(vrqueue_t *vq, int pos)
+{
+    process_t *proc = vq->heap[pos];
+    for (;;)
+    {
+        int filho = 2 * pos + 1;
+        if (filho >= vq->size) break;
+
+        if (filho + 1 < vq->size && vrqueue_antes(vq->heap[filho + 1], vq->heap[filho]))
+        {
+            filho++;
+        }
+
+        if (!vrqueue_antes(vq->heap[filho], proc)) break;
+
+        vrqueue_coloca(vq, pos, vq->heap[filho]);
+        pos = filho;
+    }
+
+    vrqueue_coloca(vq, pos, proc);
+}
+
+void vrqueue_push(vrqueue_t *vq, process_t *proc)
+{
+    vr_node_t *node = proc_get_vr_node_ptr(proc);
+    assert(node->index == -1);
+
+    if (vq->size == vq->capacity)
+    {
+        vq->capacity *= 2;
+        vq->heap = realloc(vq->heap, vq->capacity * sizeof(process_t *));
+        assert(vq->heap != NULL);
+    }
+
+    node->seq = vq->next_seq++;
+    vrqueue_coloca(vq, vq->size, proc);
+    vq->size++;
+    vrqueue_sobe(vq, vq->size - 1);
+}
+
+void vrqueue_remove(vrqueue_t *vq, process_t *proc)
+{
+    vr_node_t *node = proc_get_vr_node_ptr(proc);
+    int pos = node->index;
+    if (pos == -1) return;
+    assert(pos < vq->size && vq->heap[pos] == proc);
+
+    node->index = -1;
+    vq->size--;
+    if (pos == vq->size) return;
+
+    // o último ocupa o lugar do retirado, e pode ter que subir ou descer
+    process_t *ultimo = vq->heap[vq->size];
+    vrqueue_coloca(vq, pos, ultimo);
+    vrqueue_sobe(vq, pos);
+    if (vq->heap[pos] == ultimo)
+    {
+        vrqueue_desce(vq, pos);
+    }
+}
+
+process_t *vrqueue_peek(vrqueue_t *vq)
+{
+    if (vq->size == 0) return NULL;
+
+    return vq->heap[0];
+}
+
+process_t *vrqueue_pop(vrqueue_t *vq)
+{
+    process_t *proc = vrqueue_peek(vq);
+    if (proc != NULL)
+    {
+        vrqueue_remove(vq, proc);
+    }
+
+    return proc;
+}
+
+bool vrqueue_contains(process_t *proc)
+{
+    return proc_get_vr_node_ptr(proc)->index != -1;
+}
+
+int vrqueue_size(vrqueue_t *vq)
+{
+    return vq->size;
+}
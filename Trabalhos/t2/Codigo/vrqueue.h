@@ -0,0 +1,39 @@
+#ifndef VRQUEUE_H
+#define VRQUEUE_H
+
+#include <stdbool.h>
+
+#include "proc.h"
+
+// fila de prontos ordenada pelo tempo virtual de execução (vruntime) dos
+// processos, usada pelo escalonador justo (tipo 4 em so.c)
+// é um heap binário de mínimo; a posição de cada processo no heap fica no
+// próprio processo (vr_node_t), então inserir, retirar o primeiro e retirar do
+// meio são O(log n), e ver o primeiro é O(1)
+// o vruntime de um processo não pode mudar enquanto ele está na fila; processos
+// com o mesmo vruntime saem na ordem de chegada
+
+typedef struct vrqueue_t vrqueue_t;
+
+vrqueue_t *vrqueue_create(void);
+void vrqueue_destroy(vrqueue_t *vq);
+
+// coloca o processo na fila, de acordo com o seu vruntime atual
+// o processo não pode estar em nenhuma fila de tempo virtual
+void vrqueue_push(vrqueue_t *vq, process_t *proc);
+
+// retira o processo da fila; não faz nada se não estiver nela
+void vrqueue_remove(vrqueue_t *vq, process_t *proc);
+
+// retorna o processo de menor vruntime, ou NULL
+process_t *vrqueue_peek(vrqueue_t *vq);
+
+// retira e retorna o processo de menor vruntime
+process_t *vrqueue_pop(vrqueue_t *vq);
+
+// retorna true se o processo está em alguma fila de tempo virtual
+bool vrqueue_contains(process_t *proc);
+
+int vrqueue_size(vrqueue_t *vq);
+
+#endif